@@ -0,0 +1,702 @@
+#include "board.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#define PARALLEL_REVEAL_CELLS (1 << 20)     // Boards with fewer cells always reveal on one thread
+#define PARALLEL_REVEAL_FRONTIER 4096       // Queued cells at which a cascade is handed to every core
+#define PARALLEL_REVEAL_THREADS 64
+#define PARALLEL_REVEAL_CORES 3             // Fewer cores always reveal on one thread
+
+/*
+ * This file provides implementations for the member functions of Board class declared in board.h
+ */
+
+namespace {
+
+// Threads of a parallel reveal wait here for each other between the steps of every wave
+// Waves are short, so waiting threads spin (yielding) instead of sleeping on a condition variable
+class SpinBarrier
+{
+public:
+    explicit SpinBarrier(int threadAmount) : m_threadAmount{threadAmount} {}
+
+    void wait()
+    {
+        int generation = m_generation.load(std::memory_order_acquire);
+        if (m_arrivedAmount.fetch_add(1, std::memory_order_acq_rel) + 1 == m_threadAmount) {
+            m_arrivedAmount.store(0, std::memory_order_relaxed);
+            m_generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+
+        while (m_generation.load(std::memory_order_acquire) == generation)
+            std::this_thread::yield();
+    }
+
+private:
+    const int m_threadAmount;
+    std::atomic<int> m_arrivedAmount{0};
+    std::atomic<int> m_generation{0};
+};
+
+// Threads of a parallel reveal, one per core, or 1 when there are too few cores to make up for the extra work
+// Asking the system for the core count is a system call, so it is asked once
+int revealThreadAmount()
+{
+    static const int threadAmount = [] {
+        unsigned coreAmount = std::thread::hardware_concurrency();
+        return coreAmount < PARALLEL_REVEAL_CORES ? 1 : int(std::min<unsigned>(coreAmount, PARALLEL_REVEAL_THREADS));
+    }();
+    return threadAmount;
+}
+
+/*
+ * Threads of parallel reveals, started by the first one that needs them and kept asleep for the next ones
+ * One parallel reveal runs at a time, a reveal that finds the pool busy stays on its own thread
+ * The pool is never destroyed, so exiting the program doesn't wait for its threads
+ *
+ * The pool also keeps the bids of the running reveal, one per cell of the largest board revealed so far.
+ * Every reveal leaves them all 0, so the next one, of any board, can use them as they are
+ */
+class RevealPool
+{
+public:
+    static RevealPool& instance()
+    {
+        static RevealPool* pool = new RevealPool;
+        return *pool;
+    }
+
+    using Work = std::function<void(int, std::atomic<std::uint32_t>*)>;
+
+    // Runs work(0, bids) on the calling thread and work(1, bids) ... work(threadAmount - 1, bids) on the pool,
+    // bids has at least cellAmount entries, all 0. Returns false if the pool is busy
+    bool tryRun(int threadAmount, int cellAmount, const Work& work)
+    {
+        std::unique_lock<std::mutex> run{m_runMutex, std::try_to_lock};
+        if (!run.owns_lock())
+            return false;
+
+        if (m_bidAmount < cellAmount) {
+            m_bids.reset(new std::atomic<std::uint32_t>[std::size_t(cellAmount)]());
+            m_bidAmount = cellAmount;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            while (int(m_threads.size()) < threadAmount - 1) {
+                int worker = int(m_threads.size()) + 1;
+                m_threads.emplace_back([this, worker]() { serve(worker); });
+            }
+            m_work = &work;
+            m_threadAmount = threadAmount;
+            m_pendingAmount = threadAmount - 1;
+            m_generation++;
+        }
+        m_wake.notify_all();
+
+        work(0, m_bids.get());
+
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_done.wait(lock, [this]() { return m_pendingAmount == 0; });
+        m_work = nullptr;
+        return true;
+    }
+
+private:
+    std::mutex m_runMutex;                  // Held by the reveal using the pool, guards the bids
+    std::unique_ptr<std::atomic<std::uint32_t>[]> m_bids;
+    int m_bidAmount = 0;
+    std::mutex m_mutex;                     // Guards everything below
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const Work* m_work = nullptr;
+    int m_threadAmount = 0;                 // Threads of the current run, including the calling thread
+    int m_pendingAmount = 0;                // Pool threads of the current run that haven't finished
+    std::uint64_t m_generation = 0;         // Increased by every run
+    std::vector<std::thread> m_threads;
+
+    void serve(int worker)
+    {
+        std::uint64_t generation = 0;
+        std::unique_lock<std::mutex> lock{m_mutex};
+        for (;;) {
+            m_wake.wait(lock, [this, generation]() { return m_generation != generation; });
+            generation = m_generation;
+            if (worker >= m_threadAmount)
+                continue;
+
+            const Work& work = *m_work;
+            lock.unlock();
+            work(worker, m_bids.get());
+            lock.lock();
+
+            if (--m_pendingAmount == 0)
+                m_done.notify_one();
+        }
+    }
+};
+
+} // namespace
+
+// Initializes an empty board, no mines and no revealed cells
+Board::Board(const Topology& topology)
+    : m_topology{topology}
+    , m_state(topology.cellAmount(), 0)
+    , m_numberOfNeighbouringMines(topology.cellAmount(), 0)
+    , m_visibleState(topology.cellAmount(), Hidden)
+{
+    if (HintSweep::supports(topology))
+        m_hintSweep = HintSweep(topology);
+
+    for (int i = 0; i < topology.cellAmount(); i++) {
+        if (!topology.isActive(i))
+            m_visibleState[i] = Hole;
+    }
+}
+
+// A revealed cell shows either a mine or its number
+void Board::showCell(int index)
+{
+    m_visibleState[index] = (m_state[index] & Mine) ? std::uint8_t(RevealedMine) : m_numberOfNeighbouringMines[index];
+}
+
+/*
+ * Distribute the mines over active cells randomly using a mersenne-twister random number generator
+ * The same seed always produces the same layout on the same topology
+ */
+void Board::generateMines(int mineAmount, std::uint32_t seed)
+{
+    // There can't be more mines than cells
+    if (mineAmount > m_topology.activeCellAmount())
+        mineAmount = m_topology.activeCellAmount();
+
+    std::mt19937 mt{seed};
+    // Generated numbers should be limited to interval of (0, numberOfCells)
+    std::uniform_int_distribution<> generateMineIndex{0, m_topology.cellAmount() - 1};
+
+    int remainingMineAmount = mineAmount;
+
+    // Randomly distribute mines until there is no mine left to place.
+    while (remainingMineAmount > 0) {
+
+        int mineIndex = generateMineIndex(mt);
+
+        // If that cell is a hole or already has a mine, get another random cell
+        if (!m_topology.isActive(mineIndex) || isMine(mineIndex))
+            continue;
+
+        setMine(mineIndex, true);
+        remainingMineAmount--;
+    }
+}
+
+// Places or removes a single mine
+void Board::setMine(int index, bool isMine)
+{
+    if (isMine == this->isMine(index))
+        return;
+
+    if (isMine) {
+        m_state[index] |= Mine;
+        m_mineAmount++;
+    }
+    else {
+        m_state[index] &= ~Mine;
+        m_mineAmount--;
+    }
+}
+
+// Counts the mines among the neighbours of every cell, cells with mine don't get a number
+void Board::setMineNumbers()
+{
+    for (int i = 0; i < m_topology.cellAmount(); i++) {
+
+        if (m_state[i] & Mine) {
+            m_numberOfNeighbouringMines[i] = 0;
+            continue;
+        }
+
+        int neighbouringMines = 0;
+        for (const std::uint32_t* n = m_topology.neighboursBegin(i); n != m_topology.neighboursEnd(i); ++n) {
+            if (m_state[*n] & Mine)
+                neighbouringMines++;
+        }
+
+        m_numberOfNeighbouringMines[i] = std::uint8_t(neighbouringMines);
+    }
+}
+
+/*
+ * Reveals the cell, if the revealed cell is an empty cell all of its neighbours are also revealed
+ * The cascade is a breadth-first walk over an explicit queue instead of recursion so that large openings
+ * can't overflow the call stack, and revealedCells is ordered by distance from the clicked cell (a wave front)
+ */
+GameStatus Board::reveal(int index, std::vector<int>& revealedCells)
+{
+    // Nothing can be revealed once the game is over, or on a hole
+    if (m_status != GameStatus::Playing || !m_topology.isActive(index) || isRevealed(index))
+        return m_status;
+
+    // Cells are marked revealed when they are queued, so each cell enters the queue only once
+    m_revealQueue.clear();
+    m_revealQueue.push_back(index);
+    m_state[index] |= Revealed;
+
+    // Waves take about twice the work of this loop, so they are not worth it on one or two cores
+    const int threadAmount = std::min(m_revealThreadAmount > 0 ? m_revealThreadAmount : revealThreadAmount(), PARALLEL_REVEAL_THREADS);
+    bool isParallel = threadAmount > 1 && m_topology.cellAmount() >= PARALLEL_REVEAL_CELLS;
+
+    for (std::size_t head = 0; head < m_revealQueue.size(); head++) {
+
+        // A giant opening is continued on every core, the cells still queued are its first wave
+        if (isParallel && m_revealQueue.size() - head >= PARALLEL_REVEAL_FRONTIER) {
+            if (revealInWaves(head, threadAmount, revealedCells))
+                break;
+            isParallel = false;
+        }
+
+        int current = m_revealQueue[head];
+        revealedCells.push_back(current);
+        showCell(current);
+
+        // If player reveals a mine, the game ends with a lose
+        if (m_state[current] & Mine) {
+            m_status = GameStatus::Lost;
+            continue;
+        }
+
+        m_revealedCellAmount++;
+
+        // Continue with the neighbours of empty cells, mines are never revealed by the cascade
+        if (m_numberOfNeighbouringMines[current] == 0) {
+            for (const std::uint32_t* n = m_topology.neighboursBegin(current); n != m_topology.neighboursEnd(current); ++n) {
+                if (!(m_state[*n] & (Revealed | Mine))) {
+                    m_state[*n] |= Revealed;
+                    m_revealQueue.push_back(int(*n));
+                }
+            }
+        }
+    }
+
+    // If the player revealed all non-mine cells, the game ends with a win
+    if (m_status == GameStatus::Playing && m_revealedCellAmount + m_mineAmount == m_topology.activeCellAmount())
+        m_status = GameStatus::Won;
+
+    return m_status;
+}
+
+/*
+ * Continues the cascade of reveal() on all cores, from the cells of m_revealQueue after head (revealed, not shown yet)
+ * Returns false, without touching the board, if another board is revealing on the pool threads
+ *
+ * The queue of reveal() is cut into waves: a wave is every cell queued so far, the next wave is every cell
+ * they queue. Each thread takes a contiguous slice of the wave, and a cell reachable from several cells
+ * of the wave is given to the first of them in wave order (a compare-and-swap keeps the smallest position),
+ * which is the cell that would have queued it on one thread. Slices are joined in order, so revealedCells,
+ * the visible state and the score end up exactly as the single threaded cascade leaves them
+ *
+ * Cells of the cascade never contain a mine, so the game can only be won here
+ */
+bool Board::revealInWaves(std::size_t head, int threadAmount, std::vector<int>& revealedCells)
+{
+    std::vector<int> waves[2];
+    std::vector<std::vector<int>> queued(static_cast<std::size_t>(threadAmount));    // Cells queued by each slice of the wave
+    std::vector<std::size_t> offsets(std::size_t(threadAmount) + 1);
+    SpinBarrier barrier{threadAmount};
+
+    // queuedBy holds the position in the wave (plus one) of the cell that queues each cell, 0 when no cell of
+    // the wave reaches it. The owner clears the entry when it takes the cell, so every entry is 0 between waves
+    // and between reveals
+    RevealPool::Work work = [&](int thread, std::atomic<std::uint32_t>* queuedBy) {
+        if (thread == 0) {
+            waves[0].swap(m_revealQueue);
+            waves[0].erase(waves[0].begin(), waves[0].begin() + std::ptrdiff_t(head));
+        }
+        barrier.wait();
+
+        std::vector<int>& threadQueued = queued[std::size_t(thread)];
+
+        for (int waveNumber = 0; ; waveNumber++) {
+            const std::vector<int>& wave = waves[waveNumber % 2];
+            std::vector<int>& nextWave = waves[(waveNumber + 1) % 2];
+            const std::size_t first = wave.size() * std::size_t(thread) / std::size_t(threadAmount);
+            const std::size_t last = wave.size() * std::size_t(thread + 1) / std::size_t(threadAmount);
+
+            // Every cell of the wave bids for its unrevealed neighbours, the smallest position wins
+            for (std::size_t i = first; i < last; i++) {
+                int current = wave[i];
+                if (m_numberOfNeighbouringMines[current] != 0)
+                    continue;
+
+                const std::uint32_t position = std::uint32_t(i + 1);
+                for (const std::uint32_t* n = m_topology.neighboursBegin(current); n != m_topology.neighboursEnd(current); ++n) {
+                    if (m_state[*n] & (Revealed | Mine))
+                        continue;
+
+                    std::uint32_t bid = queuedBy[*n].load(std::memory_order_relaxed);
+                    while ((bid == 0 || position < bid) && !queuedBy[*n].compare_exchange_weak(bid, position, std::memory_order_relaxed)) {}
+                }
+            }
+            barrier.wait();
+
+            // Show the wave and queue the neighbours it won, in the order one thread would have queued them
+            for (std::size_t i = first; i < last; i++) {
+                int current = wave[i];
+                showCell(current);
+                if (m_numberOfNeighbouringMines[current] != 0)
+                    continue;
+
+                const std::uint32_t position = std::uint32_t(i + 1);
+                for (const std::uint32_t* n = m_topology.neighboursBegin(current); n != m_topology.neighboursEnd(current); ++n) {
+                    if (queuedBy[*n].load(std::memory_order_relaxed) == position) {
+                        queuedBy[*n].store(0, std::memory_order_relaxed);
+                        m_state[*n] |= Revealed;
+                        threadQueued.push_back(int(*n));
+                    }
+                }
+            }
+            barrier.wait();
+
+            if (thread == 0) {
+                revealedCells.insert(revealedCells.end(), wave.begin(), wave.end());
+                m_revealedCellAmount += int(wave.size());
+
+                for (int t = 0; t < threadAmount; t++)
+                    offsets[std::size_t(t) + 1] = offsets[std::size_t(t)] + queued[std::size_t(t)].size();
+                nextWave.resize(offsets[std::size_t(threadAmount)]);
+            }
+            barrier.wait();
+
+            std::copy(threadQueued.begin(), threadQueued.end(), nextWave.begin() + std::ptrdiff_t(offsets[std::size_t(thread)]));
+            threadQueued.clear();
+            barrier.wait();
+
+            if (nextWave.empty())
+                return;
+        }
+    };
+
+    if (!RevealPool::instance().tryRun(threadAmount, m_topology.cellAmount(), work))
+        return false;
+
+    // Keep the larger buffer for the next reveal
+    m_revealQueue.swap(waves[0].capacity() >= waves[1].capacity() ? waves[0] : waves[1]);
+    m_revealQueue.clear();
+    return true;
+}
+
+// Flags the cell if it's not flagged, unflags it otherwise
+void Board::flagCell(int index)
+{
+    if (m_status != GameStatus::Playing || !m_topology.isActive(index) || isRevealed(index))
+        return;
+
+    m_state[index] ^= Flagged;
+
+    // If the cell is suggested as a hint, flagging should make it unsuggested
+    if (m_state[index] & Flagged)
+        m_state[index] &= ~Hinted;
+
+    m_visibleState[index] = (m_state[index] & Flagged) ? FlaggedCell : (m_state[index] & Hinted) ? HintedCell : Hidden;
+}
+
+/*
+ * Runs the marking process and returns the first safe marked unrevealed cell
+ * Returns -1 if the known information is not enough to find a safe cell
+ */
+int Board::findHint()
+{
+    if (m_status != GameStatus::Playing)
+        return -1;
+
+    markDeductions();
+
+    for (int i = 0; i < m_topology.cellAmount(); i++) {
+        if ((m_state[i] & (MarkedSafe | Revealed)) == MarkedSafe)
+            return i;
+    }
+
+    return -1;
+}
+
+// Suggests the cell to the player, a flagged cell, when hinted, should be unflagged
+void Board::setHinted(int index)
+{
+    m_state[index] |= Hinted;
+    m_state[index] &= ~Flagged;
+
+    if (!(m_state[index] & Revealed))
+        m_visibleState[index] = HintedCell;
+}
+
+// Reveals every unrevealed cell, the score is not affected
+void Board::revealAllCells(std::vector<int>& revealedCells)
+{
+    for (int i = 0; i < m_topology.cellAmount(); i++) {
+        if (m_topology.isActive(i) && !isRevealed(i)) {
+            m_state[i] |= Revealed;
+            showCell(i);
+            revealedCells.push_back(i);
+        }
+    }
+}
+
+// Reveals every unrevealed mine, the score is not affected
+void Board::revealAllMines(std::vector<int>& revealedCells)
+{
+    for (int i = 0; i < m_topology.cellAmount(); i++) {
+        if ((m_state[i] & (Mine | Revealed)) == Mine) {
+            m_state[i] |= Revealed;
+            showCell(i);
+            revealedCells.push_back(i);
+        }
+    }
+}
+
+// Iterate over each neighbour, return the number of unrevealed neighbours
+int Board::getUnrevealedNeighbourAmount(int index) const
+{
+    int unrevealedNeighbourAmount = 0;
+    for (const std::uint32_t* n = m_topology.neighboursBegin(index); n != m_topology.neighboursEnd(index); ++n) {
+        if (!(m_state[*n] & Revealed))
+            unrevealedNeighbourAmount++;
+    }
+
+    return unrevealedNeighbourAmount;
+}
+
+// Iterate over each neighbour, return the number of safe neighbours
+int Board::getSafeNeighbourAmount(int index) const
+{
+    int safeNeighbourAmount = 0;
+    for (const std::uint32_t* n = m_topology.neighboursBegin(index); n != m_topology.neighboursEnd(index); ++n) {
+        if ((m_state[*n] & (MarkedSafe | Revealed)) == MarkedSafe)
+            safeNeighbourAmount++;
+    }
+
+    return safeNeighbourAmount;
+}
+
+// Iterate over each neighbour, return the number of unsafe neighbours
+int Board::getUnsafeNeighbourAmount(int index) const
+{
+    int unsafeNeighbourAmount = 0;
+    for (const std::uint32_t* n = m_topology.neighboursBegin(index); n != m_topology.neighboursEnd(index); ++n) {
+        if ((m_state[*n] & (MarkedUnsafe | Revealed)) == MarkedUnsafe)
+            unsafeNeighbourAmount++;
+    }
+
+    return unsafeNeighbourAmount;
+}
+
+// Iterate over each neighbour, mark the unrevealed, unmarked neighbours as unsafe
+// Returns true if any cell is marked, false otherwise
+bool Board::markNeighboursAsUnsafe(int index)
+{
+    bool changeOccured = false;
+
+    for (const std::uint32_t* n = m_topology.neighboursBegin(index); n != m_topology.neighboursEnd(index); ++n) {
+        if (!(m_state[*n] & (MarkedSafe | Revealed | MarkedUnsafe))) {
+            m_state[*n] |= MarkedUnsafe;
+            changeOccured = true;
+        }
+    }
+
+    return changeOccured;
+}
+
+// Iterate over each neighbour, mark the unrevealed, unmarked neighbours as safe
+// Returns true if any cell is marked, false otherwise
+bool Board::markUnmarkedNeighboursAsSafe(int index)
+{
+    bool changeOccured = false;
+
+    for (const std::uint32_t* n = m_topology.neighboursBegin(index); n != m_topology.neighboursEnd(index); ++n) {
+        if (!(m_state[*n] & (MarkedUnsafe | Revealed | MarkedSafe))) {
+            m_state[*n] |= MarkedSafe;
+            changeOccured = true;
+        }
+    }
+
+    return changeOccured;
+}
+
+/*
+ * Describes the 7x7 window centred on the cell, as the player knows it
+ * Positions outside the board are PatternOutside, on a torus the window wraps around the edges
+ */
+void Board::localPattern(int index, LocalPattern& pattern) const
+{
+    int rowNumber = m_topology.rowNumber();
+    int columnNumber = m_topology.columnNumber();
+    int centreRow = m_topology.rowOf(index);
+    int centreColumn = m_topology.columnOf(index);
+
+    int position = 0;
+    for (int rowOffset = -PATTERN_SIDE / 2; rowOffset <= PATTERN_SIDE / 2; rowOffset++) {
+        for (int columnOffset = -PATTERN_SIDE / 2; columnOffset <= PATTERN_SIDE / 2; columnOffset++) {
+
+            int row = centreRow + rowOffset;
+            int column = centreColumn + columnOffset;
+
+            if (m_topology.isWrapped()) {
+                row = (row + rowNumber) % rowNumber;
+                column = (column + columnNumber) % columnNumber;
+            }
+            else if (row < 0 || row >= rowNumber || column < 0 || column >= columnNumber) {
+                pattern[position++] = PatternOutside;
+                continue;
+            }
+
+            int cell = m_topology.indexOf(row, column);
+            std::uint8_t state = m_state[cell];
+
+            // The outer ring only matters through the unknown and mined cells it adds to the numbers at distance 2,
+            // everything else on it is folded into PatternOutside so that more windows share the same pattern
+            bool isOuterRing = rowOffset == -PATTERN_SIDE / 2 || rowOffset == PATTERN_SIDE / 2
+                               || columnOffset == -PATTERN_SIDE / 2 || columnOffset == PATTERN_SIDE / 2;
+
+            if (!m_topology.isActive(cell))
+                pattern[position++] = PatternOutside;
+            else if (isOuterRing && (state & Revealed))
+                pattern[position++] = (state & Mine) ? PatternMine : PatternOutside;
+            else if (isOuterRing && !(state & MarkedUnsafe) && (state & MarkedSafe))
+                pattern[position++] = PatternOutside;
+            else if (state & Revealed)
+                pattern[position++] = (state & Mine) ? std::uint8_t(PatternMine) : m_numberOfNeighbouringMines[cell];
+            else if (state & MarkedUnsafe)
+                pattern[position++] = PatternMine;
+            else if (state & MarkedSafe)
+                pattern[position++] = PatternSafe;
+            else
+                pattern[position++] = PatternUnknown;
+        }
+    }
+}
+
+/*
+ * Solves the local pattern of every revealed number that still has unknown neighbours
+ * and marks the neighbours it proves safe or mined
+ * Returns true if any cell is marked, false otherwise
+ */
+bool Board::markPatternDeductions()
+{
+    // On a torus narrower than the window, the window would contain the same cell twice
+    if (m_topology.isWrapped() && (m_topology.rowNumber() < PATTERN_SIDE || m_topology.columnNumber() < PATTERN_SIDE))
+        return false;
+
+    bool changeOccured = false;
+    LocalPattern pattern;
+    DeductionCache* cache = m_isCacheSet ? m_deductionCache : &DeductionCache::shared();
+
+    for (int i = 0; i < m_topology.cellAmount(); i++) {
+
+        if (!(m_state[i] & Revealed) || m_numberOfNeighbouringMines[i] == 0)
+            continue;
+
+        // Only cells on the frontier, with neighbours that are neither revealed nor marked, can give new conclusions
+        bool hasUnknownNeighbour = false;
+        for (const std::uint32_t* n = m_topology.neighboursBegin(i); n != m_topology.neighboursEnd(i); ++n) {
+            if (!(m_state[*n] & (Revealed | MarkedSafe | MarkedUnsafe)))
+                hasUnknownNeighbour = true;
+        }
+        if (!hasUnknownNeighbour)
+            continue;
+
+        localPattern(i, pattern);
+        LocalDeduction deduction = cache ? cache->deduce(pattern) : solveLocalPattern(pattern);
+
+        if (deduction.safeNeighbours == 0 && deduction.mineNeighbours == 0)
+            continue;
+
+        // Bits follow the row by row order of the neighbours, see LocalDeduction
+        int bit = 0;
+        for (int rowOffset = -1; rowOffset <= 1; rowOffset++) {
+            for (int columnOffset = -1; columnOffset <= 1; columnOffset++) {
+
+                if (rowOffset == 0 && columnOffset == 0)
+                    continue;
+
+                int mask = 1 << bit++;
+                if (!((deduction.safeNeighbours | deduction.mineNeighbours) & mask))
+                    continue;
+
+                int row = m_topology.rowOf(i) + rowOffset;
+                int column = m_topology.columnOf(i) + columnOffset;
+                if (m_topology.isWrapped()) {
+                    row = (row + m_topology.rowNumber()) % m_topology.rowNumber();
+                    column = (column + m_topology.columnNumber()) % m_topology.columnNumber();
+                }
+
+                int neighbour = m_topology.indexOf(row, column);
+                m_state[neighbour] |= (deduction.safeNeighbours & mask) ? MarkedSafe : MarkedUnsafe;
+                changeOccured = true;
+            }
+        }
+    }
+
+    return changeOccured;
+}
+
+/*
+ * Repeats the marking process until a pass with no change to cell marks is made
+ * Rule 1: a revealed cell with as many unrevealed, not-safe neighbours as its number has only mines around it
+ * Rule 2: a revealed cell whose number equals its unsafe neighbours has no other mine around it
+ * Boards without wrap-around apply the rules to the whole board at once on bitplanes (HintSweep),
+ * the others visit each cell and its neighbour list
+ */
+void Board::markSimpleDeductions()
+{
+    if (HintSweep::supports(m_topology)) {
+        m_hintSweep.load(m_state.data(), m_numberOfNeighbouringMines.data());
+        while (m_hintSweep.sweep()) {
+        }
+        m_hintSweep.store(m_state.data());
+        return;
+    }
+
+    bool changeOccured = true;
+    while (changeOccured) {
+
+        changeOccured = false;
+
+        // Mark cells that are certain to contain a mine as unsafe
+        for (int i = 0; i < m_topology.cellAmount(); i++) {
+            if ((m_state[i] & Revealed) && m_numberOfNeighbouringMines[i] != 0) {
+                if (m_numberOfNeighbouringMines[i] == getUnrevealedNeighbourAmount(i) - getSafeNeighbourAmount(i)) {
+                    if (markNeighboursAsUnsafe(i))
+                        changeOccured = true;
+                }
+            }
+        }
+
+        // Mark cells that are certain to not contain a mine as safe
+        for (int i = 0; i < m_topology.cellAmount(); i++) {
+            if ((m_state[i] & Revealed) && m_numberOfNeighbouringMines[i] != 0) {
+                if (m_numberOfNeighbouringMines[i] == getUnsafeNeighbourAmount(i)) {
+                    if (markUnmarkedNeighboursAsSafe(i))
+                        changeOccured = true;
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Applies the simple rules until they find nothing new, then solves the local patterns,
+ * which also finds deductions that need two or more numbers together
+ * Local patterns are more expensive, so the simple rules always run first
+ */
+void Board::markDeductions()
+{
+    do {
+        markSimpleDeductions();
+    } while (markPatternDeductions());
+}
@@ -0,0 +1,122 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <cstdint>
+#include <vector>
+#include "deductioncache.h"
+#include "hintsweep.h"
+#include "topology.h"
+
+/*
+ * This class holds the game state and the game rules, independent of any UI element
+ * The state of every cell is kept in flat arrays indexed like the Topology,
+ * neighbour interactions (reveal, mine counting, hint) iterate over the precomputed adjacency of the Topology
+ * On boards of millions of cells, a cascade that opens thousands of cells is continued on all cores
+ *
+ * Cell and Widget classes act as the UI on top of a Board
+ */
+
+enum class GameStatus {
+    Playing,        // Game continues
+    Won,            // All non-mine cells are revealed
+    Lost            // A mine is revealed
+};
+
+class Board
+{
+public:
+    // Bits of the state byte kept for every cell
+    enum CellFlag : std::uint8_t {
+        Mine         = 1 << 0,     // Cell contains a mine
+        Revealed     = 1 << 1,     // Cell is clicked, its content is visible
+        Flagged      = 1 << 2,     // Cell is flagged by the user
+        Hinted       = 1 << 3,     // Cell is suggested as a hint to the player
+        MarkedSafe   = 1 << 4,     // Used in hint algorithm, denotes the cell is certain to not contain a mine
+        MarkedUnsafe = 1 << 5      // Used in hint algorithm, denotes the cell is certain to contain a mine
+    };
+
+    // Codes of the visible state buffer, what a player can see on each cell
+    enum VisibleCell : std::uint8_t {
+        // 0 ... 8 : revealed cell showing its number of neighbouring mines
+        Hidden       = 9,          // Unrevealed cell
+        FlaggedCell  = 10,         // Unrevealed cell flagged by the user
+        HintedCell   = 11,         // Unrevealed cell suggested as a hint
+        RevealedMine = 12,         // Revealed cell with mine
+        Hole         = 13          // Grid position that is not part of the board
+    };
+
+    explicit Board(const Topology& topology);
+
+    const Topology& topology() const { return m_topology; }
+
+    // Setting up a game
+    void generateMines(int mineAmount, std::uint32_t seed);        // Distributes mines randomly over active cells
+    void setMine(int index, bool isMine);                          // Places or removes a mine, used to load fixed layouts
+    void setMineNumbers();                                         // Calculates the number of neighbouring mines of each cell
+
+    // Player actions, revealed indices are appended to revealedCells in reveal order
+    GameStatus reveal(int index, std::vector<int>& revealedCells); // Reveals the cell, cascades over empty cells
+    void flagCell(int index);                                      // Flags the cell, or unflags it if it is already flagged
+    int findHint();                                                // Runs the hint algorithm, returns a safe unrevealed cell or -1
+    void setHinted(int index);                                     // Marks the cell as suggested to the player
+    void revealAllCells(std::vector<int>& revealedCells);          // Reveals every cell, used when the game is won
+    void revealAllMines(std::vector<int>& revealedCells);          // Reveals every mine, used when the game is lost
+
+    // Cell queries
+    bool isMine(int index) const { return m_state[index] & Mine; }
+    bool isRevealed(int index) const { return m_state[index] & Revealed; }
+    bool isFlagged(int index) const { return m_state[index] & Flagged; }
+    bool isHinted(int index) const { return m_state[index] & Hinted; }
+    bool isMarkedSafe(int index) const { return m_state[index] & MarkedSafe; }
+    bool isMarkedUnsafe(int index) const { return m_state[index] & MarkedUnsafe; }
+    int numberOfNeighbouringMines(int index) const { return m_numberOfNeighbouringMines[index]; }
+
+    // VisibleCell code of every grid position in index order, kept up to date by every action
+    // Contains nothing a player couldn't see, so it can be handed to bots as is
+    const std::uint8_t* visibleState() const { return m_visibleState.data(); }
+
+    // Game queries
+    GameStatus status() const { return m_status; }
+    int mineAmount() const { return m_mineAmount; }
+    int revealedCellAmount() const { return m_revealedCellAmount; }   // Number of revealed non-mine cells, displayed as the score
+
+    // Used for hint algorithm
+    int getUnrevealedNeighbourAmount(int index) const;      // Returns the number of neighbours that are unrevealed
+    int getSafeNeighbourAmount(int index) const;            // Returns the number of unrevealed neighbours that are marked safe
+    int getUnsafeNeighbourAmount(int index) const;          // Returns the number of unrevealed neighbours that are marked unsafe
+    bool markNeighboursAsUnsafe(int index);                 // Returns true if it marks any neighbour
+    bool markUnmarkedNeighboursAsSafe(int index);           // Returns true if it marks any neighbour
+    void localPattern(int index, LocalPattern& pattern) const;  // Describes the 7x7 window around the cell as the player knows it
+    bool markPatternDeductions();                           // Applies the local pattern deductions, returns true if it marks any cell
+    void markSimpleDeductions();                            // Applies the two simple hint rules until nothing changes
+    void markDeductions();                                  // Applies the hint rules until nothing changes
+
+    // Local pattern conclusions are taken from this cache, nullptr solves every pattern from scratch
+    // Without a call, each hint uses DeductionCache::shared() of the thread asking for it
+    void setDeductionCache(DeductionCache* cache) { m_deductionCache = cache; m_isCacheSet = true; }
+
+    // Threads that continue a giant cascade: 0 uses one per core, 1 always reveals on the calling thread
+    void setRevealThreadAmount(int threadAmount) { m_revealThreadAmount = threadAmount; }
+
+private:
+    Topology m_topology;
+
+    std::vector<std::uint8_t> m_state;                      // CellFlag bits of each cell
+    std::vector<std::uint8_t> m_numberOfNeighbouringMines;  // Number of neighbour cells with mine
+    std::vector<std::uint8_t> m_visibleState;               // VisibleCell code of each cell
+
+    void showCell(int index);                               // Updates the visible state of a revealed cell
+    std::vector<int> m_revealQueue;                         // Reused by reveal() to avoid reallocating on every click
+    bool revealInWaves(std::size_t head, int threadAmount, std::vector<int>& revealedCells);  // Multi-core rest of a giant cascade, false if the threads are busy
+    int m_revealThreadAmount = 0;
+
+    DeductionCache* m_deductionCache = nullptr;             // Cache given to setDeductionCache(), nullptr for none
+    bool m_isCacheSet = false;                              // When false, each hint uses the cache of its own thread
+    HintSweep m_hintSweep;                                  // Bitplane version of the simple rules, unused on boards it doesn't support
+
+    GameStatus m_status = GameStatus::Playing;
+    int m_mineAmount = 0;                                   // The total number of cells with mine
+    int m_revealedCellAmount = 0;                           // Counts the number of non-mine cells revealed so far
+};
+
+#endif // BOARD_H
@@ -0,0 +1,215 @@
+#include "boardrenderer.h"
+#include "pngencoder.h"
+#include <QColor>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <atomic>
+#include <cstring>
+
+/*
+ * This file provides implementations for the member functions of BoardRenderer class declared in boardrenderer.h
+ */
+
+// Loads the sprites once, so that drawing a tile never touches the resources or scales an image
+BoardRenderer::BoardRenderer(const Board& board, int cellSize)
+    : m_board{board}
+    , m_cellSize{cellSize > 0 ? cellSize : RENDER_CELL_SIZE}
+{
+    setTileCells(RENDER_TILE_PIXELS / m_cellSize);
+
+    // Same images as the cells of the widget, 0.png ... 8.png show the numbers
+    QString files[SpriteHole];
+    for (int i = 0; i <= 8; i++) {
+        files[i] = ":/image/" + QString::number(i) + ".png";
+    }
+    files[SpriteEmpty] = ":/image/empty.png";
+    files[SpriteFlag] = ":/image/flag.png";
+    files[SpriteWrongFlag] = ":/image/wrong-flag.png";
+    files[SpriteHint] = ":/image/hint.png";
+    files[SpriteMine] = ":/image/mine.png";
+
+    for (int i = 0; i < SpriteHole; i++) {
+        m_sprites[i] = QImage(files[i]).scaled(m_cellSize, m_cellSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+                                       .convertToFormat(QImage::Format_RGB888);
+    }
+
+    m_sprites[SpriteHole] = QImage(m_cellSize, m_cellSize, QImage::Format_RGB888);
+    m_sprites[SpriteHole].fill(QColor(QRgb(RENDER_HOLE_COLOR)));
+}
+
+void BoardRenderer::setTileCells(int tileCells)
+{
+    m_tileCells = tileCells > 0 ? tileCells : 1;
+}
+
+int BoardRenderer::tileRowAmount() const
+{
+    return (m_board.topology().rowNumber() + m_tileCells - 1) / m_tileCells;
+}
+
+int BoardRenderer::tileColumnAmount() const
+{
+    return (m_board.topology().columnNumber() + m_tileCells - 1) / m_tileCells;
+}
+
+// Follows what the widget shows: flags stay on unrevealed cells, and a wrong flag is shown once the game is lost
+int BoardRenderer::spriteOf(int index) const
+{
+    if (!m_board.topology().isActive(index))
+        return SpriteHole;
+
+    if (m_board.isRevealed(index))
+        return m_board.isMine(index) ? SpriteMine : m_board.numberOfNeighbouringMines(index);
+
+    if (m_board.isFlagged(index))
+        return (m_board.status() == GameStatus::Lost && !m_board.isMine(index)) ? SpriteWrongFlag : SpriteFlag;
+
+    if (m_board.isHinted(index))
+        return SpriteHint;
+
+    return SpriteEmpty;
+}
+
+// Every pixel row of a cell row is a sequence of sprite rows, each one copied as is
+void BoardRenderer::renderCells(int firstRow, int rowAmount, int firstColumn, int columnAmount,
+                                uchar* pixels, std::size_t bytesPerLine) const
+{
+    const Topology& topology = m_board.topology();
+    const std::size_t spriteBytes = std::size_t(m_cellSize) * 3;
+
+    std::vector<const QImage*> rowSprites(static_cast<std::size_t>(columnAmount));
+
+    for (int row = 0; row < rowAmount; row++) {
+
+        for (int column = 0; column < columnAmount; column++)
+            rowSprites[std::size_t(column)] = &m_sprites[spriteOf(topology.indexOf(firstRow + row, firstColumn + column))];
+
+        for (int y = 0; y < m_cellSize; y++) {
+            uchar* line = pixels + (std::size_t(row) * std::size_t(m_cellSize) + std::size_t(y)) * bytesPerLine;
+            for (int column = 0; column < columnAmount; column++)
+                std::memcpy(line + std::size_t(column) * spriteBytes, rowSprites[std::size_t(column)]->constScanLine(y), spriteBytes);
+        }
+    }
+}
+
+QImage BoardRenderer::renderTile(int tileRow, int tileColumn) const
+{
+    int firstRow = tileRow * m_tileCells;
+    int firstColumn = tileColumn * m_tileCells;
+    int rowAmount = std::min(m_tileCells, m_board.topology().rowNumber() - firstRow);
+    int columnAmount = std::min(m_tileCells, m_board.topology().columnNumber() - firstColumn);
+
+    if (rowAmount <= 0 || columnAmount <= 0)
+        return QImage();
+
+    QImage tile(columnAmount * m_cellSize, rowAmount * m_cellSize, QImage::Format_RGB888);
+    renderCells(firstRow, rowAmount, firstColumn, columnAmount, tile.bits(), std::size_t(tile.bytesPerLine()));
+    return tile;
+}
+
+/*
+ * Tiles are drawn and saved by the threads of the global pool, each thread holds one tile at a time
+ * tiles.txt describes the grid, so the tiles can be put back together
+ */
+bool BoardRenderer::writeTiles(const QString& directory) const
+{
+    QDir outputDirectory(directory);
+    if (!outputDirectory.mkpath("."))
+        return false;
+
+    QFile description(outputDirectory.filePath("tiles.txt"));
+    if (!description.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    QTextStream stream(&description);
+    stream << "rows " << m_board.topology().rowNumber() << "\n"
+           << "columns " << m_board.topology().columnNumber() << "\n"
+           << "cell " << m_cellSize << "\n"
+           << "tile " << m_tileCells << "\n"
+           << "tiles " << tileRowAmount() << " " << tileColumnAmount() << "\n";
+    description.close();
+
+    std::vector<int> tiles(std::size_t(tileRowAmount()) * std::size_t(tileColumnAmount()));
+    for (std::size_t i = 0; i < tiles.size(); i++)
+        tiles[i] = int(i);
+
+    std::atomic<bool> isFailed{false};
+    const int columnAmount = tileColumnAmount();
+
+    QtConcurrent::blockingMap(tiles, [&](int& tile) {
+        int tileRow = tile / columnAmount;
+        int tileColumn = tile % columnAmount;
+        QString name = QString("tile_%1_%2.png").arg(tileRow).arg(tileColumn);
+
+        if (!renderTile(tileRow, tileColumn).save(outputDirectory.filePath(name), "PNG"))
+            isFailed = true;
+    });
+
+    return !isFailed;
+}
+
+/*
+ * A band is one row of tiles over the whole width, drawn and compressed on a thread of the global pool
+ * As many bands as there are threads are prepared at once, then written in order
+ */
+bool BoardRenderer::writePng(const QString& path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    const int width = m_board.topology().columnNumber() * m_cellSize;
+    const int height = m_board.topology().rowNumber() * m_cellSize;
+    const std::size_t rowBytes = PngEncoder::rowBytes(width);
+
+    PngEncoder encoder;
+    std::vector<std::uint8_t> out;
+
+    auto flush = [&]() {
+        bool isWritten = file.write(reinterpret_cast<const char*>(out.data()), qint64(out.size())) == qint64(out.size());
+        out.clear();
+        return isWritten;
+    };
+
+    encoder.begin(width, height, out);
+    if (!flush())
+        return false;
+
+    struct Band
+    {
+        int tileRow;
+        PngBand png;
+    };
+
+    const int bandAmount = tileRowAmount();
+    const int batchSize = std::max(1, QThreadPool::globalInstance()->maxThreadCount());
+
+    for (int firstBand = 0; firstBand < bandAmount; firstBand += batchSize) {
+
+        std::vector<Band> bands;
+        for (int i = firstBand; i < std::min(bandAmount, firstBand + batchSize); i++)
+            bands.push_back({i, PngBand()});
+
+        QtConcurrent::blockingMap(bands, [&](Band& band) {
+            int firstRow = band.tileRow * m_tileCells;
+            int rowAmount = std::min(m_tileCells, m_board.topology().rowNumber() - firstRow);
+
+            // Filter byte 0 (none) starts every row, the pixels follow it
+            std::vector<std::uint8_t> rows(rowBytes * std::size_t(rowAmount) * std::size_t(m_cellSize), 0);
+            renderCells(firstRow, rowAmount, 0, m_board.topology().columnNumber(), rows.data() + 1, rowBytes);
+            PngEncoder::compressBand(rows.data(), rows.size(), band.png);
+        });
+
+        for (const Band& band : bands) {
+            encoder.appendBand(band.png, out);
+            if (!flush())
+                return false;
+        }
+    }
+
+    encoder.finish(out);
+    return flush();
+}
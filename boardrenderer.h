@@ -0,0 +1,57 @@
+#ifndef BOARDRENDERER_H
+#define BOARDRENDERER_H
+
+#include <QImage>
+#include <QString>
+#include "board.h"
+
+#define RENDER_CELL_SIZE 60             // Pixel size of a cell in snapshots, the size of the sprites
+#define RENDER_TILE_PIXELS 256          // Preferred side of a tile, rounded down to whole cells
+#define RENDER_HOLE_COLOR 0xf0f0f0      // Background shown on holes of the topology
+
+/*
+ * Draws a board into images without any widget, for snapshots of boards too large to show
+ *
+ * The image is cut into fixed-size tiles of whole cells, every tile is drawn by copying rows of the
+ * cell sprites straight from the state of the Board, so tiles can be drawn on any thread
+ *
+ * writeTiles() saves every tile as its own PNG, only the tiles being drawn are ever in memory
+ * writePng() saves a single PNG: a row of tiles is drawn and compressed on each thread and the rows are
+ * written in order, so memory holds one row of tiles per thread (tile height x image width)
+ */
+class BoardRenderer
+{
+public:
+    explicit BoardRenderer(const Board& board, int cellSize = RENDER_CELL_SIZE);
+
+    void setTileCells(int tileCells);                   // Side of a tile in cells
+    int tileCells() const { return m_tileCells; }
+    int tileRowAmount() const;
+    int tileColumnAmount() const;
+
+    QImage renderTile(int tileRow, int tileColumn) const;      // Tiles at the right and bottom edges may be smaller
+    bool writeTiles(const QString& directory) const;           // Saves tile_<row>_<column>.png for every tile
+    bool writePng(const QString& path) const;                  // Saves the whole board as one PNG
+
+private:
+    enum Sprite {
+        SpriteEmpty = 9,            // 0 ... 8 are the numbers
+        SpriteFlag,
+        SpriteWrongFlag,
+        SpriteHint,
+        SpriteMine,
+        SpriteHole,
+        SpriteAmount
+    };
+
+    const Board& m_board;
+    int m_cellSize;
+    int m_tileCells;
+    QImage m_sprites[SpriteAmount];             // RGB888, scaled to the cell size
+
+    int spriteOf(int index) const;              // Sprite showing the cell as the player sees it
+    void renderCells(int firstRow, int rowAmount, int firstColumn, int columnAmount,
+                     uchar* pixels, std::size_t bytesPerLine) const;    // Draws the cells into RGB888 pixels
+};
+
+#endif // BOARDRENDERER_H
@@ -0,0 +1,553 @@
+#include "boardview.h"
+#include <QMouseEvent>
+#include <QPainter>
+#include <QResizeEvent>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+
+/*
+ * This file provides implementations for the member functions of BoardView class declared in boardview.h
+ */
+
+namespace {
+
+// Color between a and b, t = 0 gives a and t = 1 gives b
+QRgb mixColor(QRgb a, QRgb b, double t)
+{
+    auto channel = [&](int shift) {
+        double value = double((a >> shift) & 0xff) * (1 - t) + double((b >> shift) & 0xff) * t;
+        return QRgb(value + 0.5) << shift;
+    };
+    return 0xff000000u | channel(16) | channel(8) | channel(0);
+}
+
+} // namespace
+
+BoardView::BoardView(Board* board, QWidget* parent)
+    : QWidget(parent)
+    , m_board{board}
+{
+    // Same images as the cells of the widget, 0.png ... 8.png show the numbers
+    for (int i = 0; i <= 8; i++) {
+        m_spriteImages[i] = QPixmap(":/image/" + QString::number(i) + ".png");
+    }
+    m_spriteImages[SpriteEmpty] = QPixmap(":/image/empty.png");
+    m_spriteImages[SpriteFlag] = QPixmap(":/image/flag.png");
+    m_spriteImages[SpriteWrongFlag] = QPixmap(":/image/wrong-flag.png");
+    m_spriteImages[SpriteHint] = QPixmap(":/image/hint.png");
+    m_spriteImages[SpriteGuess] = QPixmap(":/image/guess.png");
+    m_spriteImages[SpriteMine] = QPixmap(":/image/mine.png");
+
+    setMinimumSize(VIEW_MINIMAP_PIXELS * 3, VIEW_MINIMAP_PIXELS * 2);
+    buildLevels();
+}
+
+// The bottom level counts cells, every level above sums 2 x 2 blocks of the level below
+void BoardView::buildLevels()
+{
+    const Topology& topology = m_board->topology();
+    m_levels.clear();
+
+    for (int shift = 1; ; shift++) {
+        BlockLevel level;
+        level.shift = shift;
+        level.rowNumber = (topology.rowNumber() + (1 << shift) - 1) >> shift;
+        level.columnNumber = (topology.columnNumber() + (1 << shift) - 1) >> shift;
+        level.blocks.resize(std::size_t(level.rowNumber) * std::size_t(level.columnNumber));
+        level.isDirty.assign(level.blocks.size(), 0);
+        m_levels.push_back(std::move(level));
+
+        BlockLevel& added = m_levels.back();
+        for (int row = 0; row < added.rowNumber; row++) {
+            for (int column = 0; column < added.columnNumber; column++)
+                added.blocks[std::size_t(row) * std::size_t(added.columnNumber) + std::size_t(column)] = countBlock(int(m_levels.size()) - 1, row, column);
+        }
+
+        if (added.rowNumber <= 1 && added.columnNumber <= 1)
+            break;
+    }
+}
+
+BoardView::BlockCounts BoardView::countBlock(int level, int blockRow, int blockColumn) const
+{
+    BlockCounts counts;
+
+    if (level == 0) {
+        const Topology& topology = m_board->topology();
+        int lastRow = std::min(blockRow * 2 + 2, topology.rowNumber());
+        int lastColumn = std::min(blockColumn * 2 + 2, topology.columnNumber());
+
+        for (int row = blockRow * 2; row < lastRow; row++) {
+            for (int column = blockColumn * 2; column < lastColumn; column++) {
+                std::uint8_t code = visibleCode(topology.indexOf(row, column));
+                if (code == Board::Hole)
+                    continue;
+                counts.active++;
+                counts.revealed += (code <= 8 || code == Board::RevealedMine) ? 1 : 0;
+                counts.flagged += code == Board::FlaggedCell ? 1 : 0;
+            }
+        }
+        return counts;
+    }
+
+    const BlockLevel& below = m_levels[std::size_t(level) - 1];
+    int lastRow = std::min(blockRow * 2 + 2, below.rowNumber);
+    int lastColumn = std::min(blockColumn * 2 + 2, below.columnNumber);
+
+    for (int row = blockRow * 2; row < lastRow; row++) {
+        for (int column = blockColumn * 2; column < lastColumn; column++) {
+            const BlockCounts& child = below.blocks[std::size_t(row) * std::size_t(below.columnNumber) + std::size_t(column)];
+            counts.active += child.active;
+            counts.revealed += child.revealed;
+            counts.flagged += child.flagged;
+        }
+    }
+    return counts;
+}
+
+void BoardView::markCell(int index)
+{
+    const Topology& topology = m_board->topology();
+    BlockLevel& level = m_levels.front();
+    int block = (topology.rowOf(index) >> 1) * level.columnNumber + (topology.columnOf(index) >> 1);
+
+    if (!level.isDirty[std::size_t(block)]) {
+        level.isDirty[std::size_t(block)] = 1;
+        level.dirtyBlocks.push_back(block);
+    }
+}
+
+// Recounts marked blocks level by level, each recounted block marks its parent
+void BoardView::recountDirtyBlocks()
+{
+    for (std::size_t l = 0; l < m_levels.size(); l++) {
+        BlockLevel& level = m_levels[l];
+
+        for (int block : level.dirtyBlocks) {
+            int row = block / level.columnNumber;
+            int column = block % level.columnNumber;
+            level.blocks[std::size_t(block)] = countBlock(int(l), row, column);
+            level.isDirty[std::size_t(block)] = 0;
+
+            if (l + 1 < m_levels.size()) {
+                BlockLevel& above = m_levels[l + 1];
+                int parent = (row >> 1) * above.columnNumber + (column >> 1);
+                if (!above.isDirty[std::size_t(parent)]) {
+                    above.isDirty[std::size_t(parent)] = 1;
+                    above.dirtyBlocks.push_back(parent);
+                }
+            }
+        }
+        level.dirtyBlocks.clear();
+    }
+}
+
+void BoardView::updateCells(const std::vector<int>& cells)
+{
+    for (int index : cells) {
+        if (!m_isHeld.empty())
+            m_isHeld[std::size_t(index)] = 0;
+        markCell(index);
+    }
+    update();
+}
+
+// Held cells are not marked, they look the same as before
+void BoardView::holdCells(const std::vector<int>& cells)
+{
+    if (m_isHeld.empty())
+        m_isHeld.assign(std::size_t(m_board->topology().cellAmount()), 0);
+    for (int index : cells) {
+        m_isHeld[std::size_t(index)] = 1;
+    }
+}
+
+void BoardView::updateCell(int index)
+{
+    markCell(index);
+    update();
+}
+
+/*
+ * Reveals the cell in the board, if the revealed cell is an empty cell all of its neighbours are also revealed
+ * Like Cell::revealCell(), the widget updates every opened cell through the cellsRevealed signal
+ */
+void BoardView::revealCell(int index)
+{
+    std::vector<int> revealedCells;
+    GameStatus status = m_board->reveal(index, revealedCells);
+
+    // If the cell is already revealed or the game is over, nothing happens
+    if (revealedCells.empty())
+        return;
+
+    emit cellsRevealed(revealedCells);
+
+    if (status == GameStatus::Lost) {
+        emit lostGame();
+    }
+    else if (status == GameStatus::Won) {
+        emit wonGame();
+    }
+}
+
+// Cells too small to see are zoomed in to the smallest sprite size first
+void BoardView::centerOn(int index)
+{
+    const Topology& topology = m_board->topology();
+    m_cellPixels = std::max(m_cellPixels, double(VIEW_SPRITE_MIN_PIXELS));
+    m_originColumn = topology.columnOf(index) + 0.5 - width() / (2 * m_cellPixels);
+    m_originRow = topology.rowOf(index) + 0.5 - height() / (2 * m_cellPixels);
+    clampOrigin();
+    update();
+}
+
+void BoardView::setGuessCell(int index)
+{
+    if (m_guessCell >= 0)
+        markCell(m_guessCell);
+    m_guessCell = index;
+    if (m_guessCell >= 0)
+        markCell(m_guessCell);
+    update();
+}
+
+void BoardView::fitBoard()
+{
+    const Topology& topology = m_board->topology();
+    double fit = std::min(double(width()) / topology.columnNumber(), double(height()) / topology.rowNumber());
+    m_cellPixels = std::min(fit, double(VIEW_MAX_CELL_PIXELS));
+    m_originColumn = (topology.columnNumber() - width() / m_cellPixels) / 2;
+    m_originRow = (topology.rowNumber() - height() / m_cellPixels) / 2;
+    update();
+}
+
+std::uint8_t BoardView::visibleCode(int index) const
+{
+    if (!m_isHeld.empty() && m_isHeld[std::size_t(index)])
+        return Board::Hidden;
+    return m_board->visibleState()[index];
+}
+
+// Follows what the cells of the widget show: a wrong flag is shown once the game is lost
+int BoardView::spriteOf(int index) const
+{
+    std::uint8_t code = visibleCode(index);
+    switch (code) {
+    case Board::Hidden:
+        return index == m_guessCell ? SpriteGuess : SpriteEmpty;
+    case Board::FlaggedCell:
+        return (m_board->status() == GameStatus::Lost && !m_board->isMine(index)) ? SpriteWrongFlag : SpriteFlag;
+    case Board::HintedCell:
+        return SpriteHint;
+    case Board::RevealedMine:
+        return SpriteMine;
+    default:
+        return code;
+    }
+}
+
+QRgb BoardView::cellColor(int index) const
+{
+    std::uint8_t code = visibleCode(index);
+
+    switch (code) {
+    case Board::Hidden:
+        return 0xff000000u | (index == m_guessCell ? VIEW_GUESS_COLOR : VIEW_HIDDEN_COLOR);
+    case Board::FlaggedCell:
+        return 0xff000000u | VIEW_FLAG_COLOR;
+    case Board::HintedCell:
+        return 0xff000000u | VIEW_HINT_COLOR;
+    case Board::RevealedMine:
+        return 0xff000000u | VIEW_MINE_COLOR;
+    case Board::Hole:
+        return 0xff000000u | VIEW_HOLE_COLOR;
+    default:
+        return code == 0 ? 0xff000000u | VIEW_REVEALED_COLOR : mixColor(VIEW_REVEALED_COLOR, VIEW_NUMBER_COLOR, 0.2 + 0.1 * code);
+    }
+}
+
+// Hidden, revealed and flagged colors weighted by the share of the block's cells in each state
+QRgb BoardView::blockColor(const BlockCounts& counts) const
+{
+    if (counts.active == 0)
+        return 0xff000000u | VIEW_HOLE_COLOR;
+
+    double revealed = double(counts.revealed) / counts.active;
+    double flagged = double(counts.flagged) / counts.active;
+    QRgb color = mixColor(VIEW_HIDDEN_COLOR, VIEW_REVEALED_COLOR, revealed);
+    return flagged > 0 ? mixColor(color, VIEW_FLAG_COLOR, std::min(1.0, flagged * 4)) : color;
+}
+
+QImage BoardView::levelImage(int level, int firstRow, int firstColumn, int rowAmount, int columnAmount) const
+{
+    QImage image(columnAmount, rowAmount, QImage::Format_RGB32);
+    const Topology& topology = m_board->topology();
+
+    for (int row = 0; row < rowAmount; row++) {
+        QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(row));
+
+        if (level < 0) {
+            for (int column = 0; column < columnAmount; column++)
+                line[column] = cellColor(topology.indexOf(firstRow + row, firstColumn + column));
+            continue;
+        }
+
+        const BlockLevel& blocks = m_levels[std::size_t(level)];
+        const BlockCounts* blockRow = blocks.blocks.data() + std::size_t(firstRow + row) * std::size_t(blocks.columnNumber) + std::size_t(firstColumn);
+        for (int column = 0; column < columnAmount; column++)
+            line[column] = blockColor(blockRow[column]);
+    }
+
+    return image;
+}
+
+void BoardView::paintEvent(QPaintEvent*)
+{
+    recountDirtyBlocks();
+
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(QRgb(VIEW_HOLE_COLOR)));
+
+    if (m_cellPixels >= VIEW_SPRITE_MIN_PIXELS)
+        paintSprites(painter);
+    else
+        paintBlocks(painter);
+
+    paintMinimap(painter);
+}
+
+// Only the cells in view are drawn, at most (width / VIEW_SPRITE_MIN_PIXELS) x (height / VIEW_SPRITE_MIN_PIXELS)
+void BoardView::paintSprites(QPainter& painter)
+{
+    const Topology& topology = m_board->topology();
+
+    // Sprites are scaled once per zoom, not once per cell
+    int size = int(std::ceil(m_cellPixels));
+    if (size != m_spriteSize) {
+        for (int i = 0; i < SpriteAmount; i++) {
+            m_sprites[i] = m_spriteImages[i].scaled(size, size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+        m_spriteSize = size;
+    }
+
+    int firstRow = std::max(0, int(std::floor(m_originRow)));
+    int firstColumn = std::max(0, int(std::floor(m_originColumn)));
+    int lastRow = std::min(topology.rowNumber(), int(std::ceil(m_originRow + height() / m_cellPixels)));
+    int lastColumn = std::min(topology.columnNumber(), int(std::ceil(m_originColumn + width() / m_cellPixels)));
+
+    for (int row = firstRow; row < lastRow; row++) {
+        int y = int(std::floor((row - m_originRow) * m_cellPixels));
+        for (int column = firstColumn; column < lastColumn; column++) {
+            int index = topology.indexOf(row, column);
+            if (!topology.isActive(index))
+                continue;
+            int x = int(std::floor((column - m_originColumn) * m_cellPixels));
+            painter.drawPixmap(x, y, size, size, m_sprites[spriteOf(index)]);
+        }
+    }
+}
+
+/*
+ * The blocks in view are written into an image, one pixel per block, which is scaled up onto the view
+ * Blocks are at least VIEW_BLOCK_MIN_PIXELS wide, so the image is never larger than the view
+ */
+void BoardView::paintBlocks(QPainter& painter)
+{
+    const Topology& topology = m_board->topology();
+
+    int level = -1;
+    int shift = 0;
+    if (m_cellPixels < VIEW_BLOCK_MIN_PIXELS) {
+        shift = int(std::ceil(std::log2(VIEW_BLOCK_MIN_PIXELS / m_cellPixels)));
+        level = std::min(shift, int(m_levels.size())) - 1;
+        shift = level + 1;
+    }
+
+    const int blockCells = 1 << shift;
+    const int rowNumber = level < 0 ? topology.rowNumber() : m_levels[std::size_t(level)].rowNumber;
+    const int columnNumber = level < 0 ? topology.columnNumber() : m_levels[std::size_t(level)].columnNumber;
+
+    int firstRow = std::max(0, int(std::floor(m_originRow / blockCells)));
+    int firstColumn = std::max(0, int(std::floor(m_originColumn / blockCells)));
+    int lastRow = std::min(rowNumber, int(std::ceil((m_originRow + height() / m_cellPixels) / blockCells)));
+    int lastColumn = std::min(columnNumber, int(std::ceil((m_originColumn + width() / m_cellPixels) / blockCells)));
+    if (firstRow >= lastRow || firstColumn >= lastColumn)
+        return;
+
+    QImage image = levelImage(level, firstRow, firstColumn, lastRow - firstRow, lastColumn - firstColumn);
+    double blockPixels = blockCells * m_cellPixels;
+    QRectF target((firstColumn * blockCells - m_originColumn) * m_cellPixels, (firstRow * blockCells - m_originRow) * m_cellPixels,
+                  (lastColumn - firstColumn) * blockPixels, (lastRow - firstRow) * blockPixels);
+    painter.drawImage(target, image);
+}
+
+// Drawn from the smallest level that fits the minimap, so it costs the same on any board
+void BoardView::paintMinimap(QPainter& painter)
+{
+    const Topology& topology = m_board->topology();
+    const double viewColumns = width() / m_cellPixels;
+    const double viewRows = height() / m_cellPixels;
+
+    // Nothing to navigate when the whole board is in view
+    m_minimapRect = QRect();
+    if (m_originColumn <= 0 && m_originRow <= 0 && m_originColumn + viewColumns >= topology.columnNumber()
+            && m_originRow + viewRows >= topology.rowNumber())
+        return;
+
+    int level = -1;
+    int rowNumber = topology.rowNumber();
+    int columnNumber = topology.columnNumber();
+    while (std::max(rowNumber, columnNumber) > VIEW_MINIMAP_PIXELS && level + 1 < int(m_levels.size())) {
+        level++;
+        rowNumber = m_levels[std::size_t(level)].rowNumber;
+        columnNumber = m_levels[std::size_t(level)].columnNumber;
+    }
+
+    // Pixels of the minimap per cell of the board
+    double scale = double(VIEW_MINIMAP_PIXELS) / std::max(topology.rowNumber(), topology.columnNumber());
+    int minimapWidth = std::max(1, int(topology.columnNumber() * scale));
+    int minimapHeight = std::max(1, int(topology.rowNumber() * scale));
+    m_minimapRect = QRect(width() - minimapWidth - 8, height() - minimapHeight - 8, minimapWidth, minimapHeight);
+
+    painter.drawImage(m_minimapRect, levelImage(level, 0, 0, rowNumber, columnNumber));
+    painter.setPen(QColor(Qt::black));
+    painter.drawRect(m_minimapRect.adjusted(-1, -1, 0, 0));
+
+    // Visible part of the board, cut to the minimap
+    double left = std::max(0.0, m_originColumn) * scale;
+    double top = std::max(0.0, m_originRow) * scale;
+    double right = std::min(double(topology.columnNumber()), m_originColumn + viewColumns) * scale;
+    double bottom = std::min(double(topology.rowNumber()), m_originRow + viewRows) * scale;
+    painter.setPen(QColor(Qt::red));
+    painter.drawRect(m_minimapRect.x() + int(left), m_minimapRect.y() + int(top),
+                     std::max(1, int(right - left)), std::max(1, int(bottom - top)));
+}
+
+int BoardView::cellAt(const QPoint& position) const
+{
+    const Topology& topology = m_board->topology();
+    int row = int(std::floor(m_originRow + position.y() / m_cellPixels));
+    int column = int(std::floor(m_originColumn + position.x() / m_cellPixels));
+
+    if (row < 0 || row >= topology.rowNumber() || column < 0 || column >= topology.columnNumber())
+        return -1;
+
+    int index = topology.indexOf(row, column);
+    return topology.isActive(index) ? index : -1;
+}
+
+/*
+ * Left click reveals and right click flags, like the buttons of the cells
+ * Dragging with the left or middle button pans, pressing on the minimap moves the view there
+ */
+void BoardView::mousePressEvent(QMouseEvent* event)
+{
+    m_pressPosition = event->pos();
+    m_lastPosition = event->pos();
+
+    if (event->button() == Qt::LeftButton && m_minimapRect.contains(event->pos())) {
+        m_isMinimapDrag = true;
+        centerOnMinimap(event->pos());
+    }
+    else if (event->button() == Qt::MiddleButton) {
+        m_isPanning = true;
+    }
+    else if (event->button() == Qt::RightButton) {
+        int index = cellAt(event->pos());
+        if (index >= 0 && m_board->status() == GameStatus::Playing) {
+            m_board->flagCell(index);
+            updateCell(index);
+        }
+    }
+}
+
+void BoardView::mouseMoveEvent(QMouseEvent* event)
+{
+    if (m_isMinimapDrag) {
+        centerOnMinimap(event->pos());
+        return;
+    }
+
+    if (!m_isPanning && (event->buttons() & Qt::LeftButton)
+            && (event->pos() - m_pressPosition).manhattanLength() >= VIEW_DRAG_PIXELS) {
+        m_isPanning = true;
+    }
+
+    if (m_isPanning) {
+        QPoint moved = event->pos() - m_lastPosition;
+        m_originColumn -= moved.x() / m_cellPixels;
+        m_originRow -= moved.y() / m_cellPixels;
+        clampOrigin();
+        update();
+    }
+    m_lastPosition = event->pos();
+}
+
+void BoardView::mouseReleaseEvent(QMouseEvent* event)
+{
+    if (event->button() == Qt::LeftButton && !m_isPanning && !m_isMinimapDrag) {
+        int index = cellAt(event->pos());
+        if (index >= 0)
+            revealCell(index);
+    }
+
+    m_isPanning = false;
+    m_isMinimapDrag = false;
+}
+
+// Each notch of the wheel zooms by the same factor, trackpads send fractions of a notch
+void BoardView::wheelEvent(QWheelEvent* event)
+{
+    double notches = event->angleDelta().y() / 120.0;
+    setZoom(m_cellPixels * std::pow(VIEW_ZOOM_STEP, notches), event->position());
+}
+
+void BoardView::resizeEvent(QResizeEvent*)
+{
+    if (!m_isFitted) {
+        fitBoard();
+        m_isFitted = true;
+    }
+    clampOrigin();
+}
+
+// Zooming out stops at half the size that fits the whole board
+void BoardView::setZoom(double cellPixels, const QPointF& anchor)
+{
+    const Topology& topology = m_board->topology();
+    double fit = std::min(double(width()) / topology.columnNumber(), double(height()) / topology.rowNumber());
+    cellPixels = std::max(std::min(cellPixels, double(VIEW_MAX_CELL_PIXELS)), std::min(fit / 2, double(VIEW_MAX_CELL_PIXELS)));
+
+    double column = m_originColumn + anchor.x() / m_cellPixels;
+    double row = m_originRow + anchor.y() / m_cellPixels;
+    m_cellPixels = cellPixels;
+    m_originColumn = column - anchor.x() / m_cellPixels;
+    m_originRow = row - anchor.y() / m_cellPixels;
+
+    clampOrigin();
+    update();
+}
+
+void BoardView::centerOnMinimap(const QPoint& position)
+{
+    const Topology& topology = m_board->topology();
+    double scale = double(m_minimapRect.width()) / topology.columnNumber();
+
+    m_originColumn = (position.x() - m_minimapRect.x()) / scale - width() / (2 * m_cellPixels);
+    m_originRow = (position.y() - m_minimapRect.y()) / scale - height() / (2 * m_cellPixels);
+    clampOrigin();
+    update();
+}
+
+// At least half of the view stays on the board
+void BoardView::clampOrigin()
+{
+    const Topology& topology = m_board->topology();
+    double viewColumns = width() / m_cellPixels;
+    double viewRows = height() / m_cellPixels;
+
+    m_originColumn = std::max(-viewColumns / 2, std::min(m_originColumn, topology.columnNumber() - viewColumns / 2));
+    m_originRow = std::max(-viewRows / 2, std::min(m_originRow, topology.rowNumber() - viewRows / 2));
+}
@@ -0,0 +1,144 @@
+#ifndef BOARDVIEW_H
+#define BOARDVIEW_H
+
+#include <QImage>
+#include <QPixmap>
+#include <QRect>
+#include <QWidget>
+#include <cstdint>
+#include <vector>
+#include "board.h"
+
+#define VIEW_SPRITE_MIN_PIXELS 12       // Smallest cell size drawn with the sprites, smaller cells are drawn as colors
+#define VIEW_BLOCK_MIN_PIXELS 2         // Smallest size of a drawn color block, smaller cells are grouped into blocks
+#define VIEW_MAX_CELL_PIXELS 60         // Largest cell size, the size of the sprites
+#define VIEW_ZOOM_STEP 1.15             // Zoom factor of one wheel notch
+#define VIEW_MINIMAP_PIXELS 160         // Longest side of the minimap
+#define VIEW_DRAG_PIXELS 4              // Mouse movement that turns a left click into a pan
+
+// Colors of cells and blocks too small for the sprites
+#define VIEW_HIDDEN_COLOR 0x9e9e9e
+#define VIEW_REVEALED_COLOR 0xe6e6e6
+#define VIEW_NUMBER_COLOR 0x3a5fc8      // Revealed numbers are tinted towards it, more for higher numbers
+#define VIEW_FLAG_COLOR 0xd0402a
+#define VIEW_HINT_COLOR 0x4cb050
+#define VIEW_GUESS_COLOR 0xe8a83c
+#define VIEW_MINE_COLOR 0x202020
+#define VIEW_HOLE_COLOR 0xf0f0f0        // Same background as the snapshots
+
+/*
+ * Draws a board of any size into a zoomable, pannable view, used instead of a button per cell on large boards
+ *
+ * The wheel zooms smoothly around the cursor, dragging pans, a click reveals a cell and a right click flags it
+ * Zoomed in, cells are drawn with the sprites; zoomed out, each cell is one color; zoomed further out,
+ * square blocks of 2^k x 2^k cells are drawn as one color mixing their revealed and flagged fractions
+ *
+ * Block counts are kept in a pyramid, each level halving the previous one, so any block is read in O(1)
+ * The level is chosen so that a block covers at least VIEW_BLOCK_MIN_PIXELS, the blocks in view are written
+ * into an image with one pixel per block and scaled up, so a frame costs the same for 100 or 10 million cells
+ * Changed cells only mark their blocks, which are recounted from the level below on the next paint
+ *
+ * The minimap in the corner shows the whole board from the pyramid, and the visible part as a rectangle
+ *
+ * Cells can be held back: they are drawn hidden, whatever the board says, until updateCells() shows them.
+ * The wave-front animation of the widget holds the cells of a cascade and shows them a step at a time
+ */
+class BoardView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit BoardView(Board* board, QWidget* parent = nullptr);
+
+    void updateCells(const std::vector<int>& cells);        // Redraws cells whose state changed on the board, showing held cells
+    void holdCells(const std::vector<int>& cells);          // Keeps drawing the cells as hidden until updateCells() is called on them
+    void updateCell(int index);
+    void revealCell(int index);                             // Same as a click on the cell
+    void centerOn(int index);                               // Pans so that the cell is in the middle of the view
+    void setGuessCell(int index);                           // Shows the cell as the suggested guess while it is hidden, -1 for none
+    void fitBoard();                                        // Zooms out until the whole board is visible
+
+signals:
+    void cellsRevealed(const std::vector<int>& revealedCells);   // Emitted with the indices of the cells opened by a reveal
+    void wonGame();                                         // Emitted when all non-mine cells are revealed
+    void lostGame();                                        // Emitted when a mine is revealed by the player
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private:
+    enum Sprite {
+        SpriteEmpty = 9,            // 0 ... 8 are the numbers
+        SpriteFlag,
+        SpriteWrongFlag,
+        SpriteHint,
+        SpriteGuess,
+        SpriteMine,
+        SpriteAmount
+    };
+
+    struct BlockCounts
+    {
+        std::uint32_t active = 0;
+        std::uint32_t revealed = 0;
+        std::uint32_t flagged = 0;
+    };
+
+    // Level of the pyramid, a block covers 2^shift x 2^shift cells
+    struct BlockLevel
+    {
+        int shift;
+        int rowNumber;
+        int columnNumber;
+        std::vector<BlockCounts> blocks;
+        std::vector<int> dirtyBlocks;           // Blocks to recount before the next paint
+        std::vector<char> isDirty;
+    };
+
+    Board* m_board;
+    std::vector<BlockLevel> m_levels;           // Shifts 1, 2, 3 ... up to a single block
+
+    double m_cellPixels = VIEW_MAX_CELL_PIXELS; // Zoom, size of a cell on screen
+    double m_originColumn = 0;                  // Board position (in cells) at the top left corner of the view
+    double m_originRow = 0;
+    bool m_isFitted = false;                    // The first resize shows the whole board
+    int m_guessCell = -1;                       // Cell suggested as a guess, not a state of the board
+    std::vector<std::uint8_t> m_isHeld;         // 1 on cells drawn hidden until shown, empty until a cell is held
+
+    QPixmap m_spriteImages[SpriteAmount];       // Sprites at VIEW_MAX_CELL_PIXELS
+    QPixmap m_sprites[SpriteAmount];            // Sprites scaled to m_spriteSize
+    int m_spriteSize = 0;
+
+    QRect m_minimapRect;                        // Where the minimap was drawn, empty if the whole board is in view
+    QPoint m_pressPosition;                     // Mouse position of the last press, to tell a click from a drag
+    QPoint m_lastPosition;
+    bool m_isPanning = false;
+    bool m_isMinimapDrag = false;
+
+    void buildLevels();                         // Counts every block from scratch
+    void markCell(int index);                   // Marks the blocks of the cell for recounting
+    void recountDirtyBlocks();
+    BlockCounts countBlock(int level, int blockRow, int blockColumn) const;   // Sums the cells or blocks below
+
+    std::uint8_t visibleCode(int index) const;  // Board::VisibleCell drawn for the cell, Hidden while it is held
+    int spriteOf(int index) const;
+    QRgb cellColor(int index) const;
+    QRgb blockColor(const BlockCounts& counts) const;
+    QImage levelImage(int level, int firstRow, int firstColumn, int rowAmount, int columnAmount) const;  // One pixel per block, level -1 is the cells
+
+    void paintSprites(QPainter& painter);
+    void paintBlocks(QPainter& painter);
+    void paintMinimap(QPainter& painter);
+
+    int cellAt(const QPoint& position) const;   // Index of the cell under the position, -1 if none
+    void setZoom(double cellPixels, const QPointF& anchor);    // Keeps the board point under the anchor in place
+    void centerOnMinimap(const QPoint& position);
+    void clampOrigin();                         // Keeps some of the board in view
+};
+
+#endif // BOARDVIEW_H
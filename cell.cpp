@@ -4,242 +4,82 @@
  * This file provides implementations for the member functions of Cell class declared in cell.h
  */
 
-// Static member definitions
-int Cell:: s_totalCellAmount = ROW_NUMBER * COLUMN_NUMBER;      // Calculate the total number of cells
-int Cell::s_mineAmount = MINE_AMOUNT;                           // Stores the total number of mines
-int Cell::s_revealedCellAmount = 0;                             // Stores the number of revealed cells to display as score
-QLabel* Cell::s_scoreLabel = nullptr;                           // Stores a reference to the scoreLabel to modify it inside Cell class
-
-// Initializes a cell object in the given row, column indices
-Cell::Cell(int rowPosition, int columnPosition, QWidget* widget, QObject *parent)
+// Initializes a cell object for the given board index
+Cell::Cell(int index, Board* board, QWidget* widget, QObject *parent)
     : QObject{parent}
-    , m_rowPosition{rowPosition}
-    , m_columnPosition{columnPosition}
+    , m_index{index}
+    , m_board{board}
     , m_widget{widget}
 
 {
 }
 
-// Assigns a number to the label depending on the number of neighbouring cells with mine
-void Cell::setNumberOfNeighbouringMines()
+// Assigns an image to the label depending on the number of neighbouring cells with mine
+void Cell::setCellLabel()
 {
     // Set the size of label depending on the number of cells
-    int labelSize = getLabelSize(COLUMN_NUMBER, ROW_NUMBER);
+    int labelSize = getLabelSize(m_board->topology().columnNumber(), m_board->topology().rowNumber());
     QSize pixmapSize(labelSize, labelSize);
 
     // Don't assign a number if that cell has a mine.
-    if (m_isMine) {
+    if (m_board->isMine(m_index)) {
         m_cellLabel->setPixmap(QPixmap(":/image/mine.png").scaled(pixmapSize));
         return;
     }
 
-    // Calculate the number of cells with mine by iterating over each neighbour
-    int neighbouringMines = 0;
-    for (int i = 0; i < m_neighbourAmount; i++) {
-        if(m_neighbourCells[i]->m_isMine) {
-            neighbouringMines++;
-        }
-    }
-
-    // Assign a number to the label based on the previously calculated neighbouringMines value
-    switch(neighbouringMines) {
-    case 0:
-        m_cellLabel->setPixmap(QPixmap(":/image/0.png").scaled(pixmapSize));
-        break;
-    case 1:
-        m_cellLabel->setPixmap(QPixmap(":/image/1.png").scaled(pixmapSize));
-        break;
-    case 2:
-        m_cellLabel->setPixmap(QPixmap(":/image/2.png").scaled(pixmapSize));
-        break;
-    case 3:
-        m_cellLabel->setPixmap(QPixmap(":/image/3.png").scaled(pixmapSize));
-        break;
-    case 4:
-        m_cellLabel->setPixmap(QPixmap(":/image/4.png").scaled(pixmapSize));
-        break;
-    case 5:
-        m_cellLabel->setPixmap(QPixmap(":/image/5.png").scaled(pixmapSize));
-        break;
-    case 6:
-        m_cellLabel->setPixmap(QPixmap(":/image/6.png").scaled(pixmapSize));
-        break;
-    case 7:
-        m_cellLabel->setPixmap(QPixmap(":/image/7.png").scaled(pixmapSize));
-        break;
-    case 8:
-        m_cellLabel->setPixmap(QPixmap(":/image/8.png").scaled(pixmapSize));
-        break;
-
-    }
-
-    // Store the number of neighbour cells with mine as a member variable of the cell
-    m_numberOfNeighbouringMines = neighbouringMines;
-
-
+    // Images are named after the number they display, 0.png ... 8.png
+    int neighbouringMines = m_board->numberOfNeighbouringMines(m_index);
+    m_cellLabel->setPixmap(QPixmap(":/image/" + QString::number(neighbouringMines) + ".png").scaled(pixmapSize));
 }
 
-// Add a neighbour for the cell
-void Cell::addNeighbour(Cell *neighbourCell)
+// Reveal the cell by making its button invisible and its label visible
+void Cell::showRevealed()
 {
-    this->m_neighbourCells[m_neighbourAmount++] = neighbourCell;
-
-}
-
-// Recursively reveals the cells and their neighbours together with revealCell()
-// This function is called whenever a cell with empty value is revealed by revealCell()
-void Cell::revealNeighbours()
-{
-    // Iterate over each neighbour
-    for (int i = 0; i < m_neighbourAmount; i++) {
-        Cell * neighbour = m_neighbourCells[i];
-        // Skip already revealed cells
-        if(neighbour->m_isRevealed)
-            continue;
-
-        // If the neighbour cell is a mine, don't reveal
-        if(neighbour->m_isMine)
-            continue;
-
-        // Reveal the neighbour cell
-        neighbour->revealCell();
-    }
+    m_cellButton->setVisible(false);
+    m_cellLabel->setVisible(true);
 }
 
 /*
- * Reveals the cell by making its button invisible and setting its label visible
- * If the revealed cell is an empty cell, all of its neighbours are also revealed
+ * Reveals the cell in the board, if the revealed cell is an empty cell all of its neighbours are also revealed
+ * The widget updates every opened cell through the cellsRevealed signal
  */
 void Cell::revealCell()
 {
-    // If the cell is already revealed, skip it
-    if(m_isRevealed)
-        return;
-
-
-    // Reveal the cell by setting its member fields to necessary values
-    m_isRevealed = true;
-    m_cellButton->setVisible(false);
-    m_cellLabel->setVisible(true);
+    std::vector<int> revealedCells;
+    GameStatus status = m_board->reveal(m_index, revealedCells);
 
-    // Only update it if it's not a mine
-    if (!m_isMine)
-        s_revealedCellAmount++;
+    // If the cell is already revealed or the game is over, nothing happens
+    if (revealedCells.empty())
+        return;
 
-    // Update score
-    s_scoreLabel->setText("Score: " + QString::number(s_revealedCellAmount));
+    emit cellsRevealed(revealedCells);
 
     // If player reveals a mine, emitted lostGame signal makes the game end with loseCondition
-    if(m_isMine) {
+    if (status == GameStatus::Lost) {
         emit lostGame();
-
     }
 
     // If the player revealed all non-mine cells, wonGame signal makes the game end with winCondition
-    else if(s_revealedCellAmount + s_mineAmount == s_totalCellAmount){
+    else if (status == GameStatus::Won) {
         emit wonGame();
     }
-
-    // Recursive call for the neighbours for empty cells
-    if(m_numberOfNeighbouringMines == 0 && !m_isMine)
-        revealNeighbours();
-}
-
-
-// Iterate over each neighbour, return the number of unrevealed neighbours
-// Used in hint algorithm
-int Cell::getUnrevealedNeighbourAmount()
-{
-    int unrevealedNeighbourAmount = 0;
-    for (int i = 0; i < m_neighbourAmount; i++) {
-        if(!m_neighbourCells[i]->m_isRevealed)
-            unrevealedNeighbourAmount++;
-    }
-
-    return unrevealedNeighbourAmount;
-}
-
-// Iterate over each neighbour, return the number of safe neighbours
-// Used in hint algorithm
-int Cell::getSafeNeighbourAmount()
-{
-    int safeNeighbourAmount = 0;
-    for (int i = 0; i < m_neighbourAmount; i++) {
-        if(m_neighbourCells[i]->m_isMarkedSafe && !m_neighbourCells[i]->m_isRevealed)
-            safeNeighbourAmount++;
-    }
-
-    return safeNeighbourAmount;
-}
-
-// Iterate over each neighbour, return the number of unsafe neighbours
-// Used in hint algorithm
-int Cell::getUnsafeNeighbourAmount()
-{
-    int unsafeNeighbourAmount = 0;
-    for (int i = 0; i < m_neighbourAmount; i++) {
-        if(m_neighbourCells[i]->m_isMarkedUnsafe && !m_neighbourCells[i]->m_isRevealed)
-            unsafeNeighbourAmount++;
-    }
-
-    return unsafeNeighbourAmount;
-}
-
-// Iterate over each neighbour, mark the unsafe neighbours
-// Used in hint algorithm.
-// Returns true if any cell is marked, false otherwise
-bool Cell::markNeighboursAsUnsafe()
-{
-    bool changeOccured = false;
-
-    for (int i = 0; i < m_neighbourAmount; i++) {
-        if(!m_neighbourCells[i]->m_isMarkedSafe && !m_neighbourCells[i]->m_isRevealed && !m_neighbourCells[i]->m_isMarkedUnsafe) {
-            m_neighbourCells[i]->m_isMarkedUnsafe = true;
-            changeOccured = true;
-        }
-    }
-
-    return changeOccured;
-
-}
-
-// Iterate over each neighbour, mark the safe neighbours
-// Used in hint algorithm.
-// Returns true if any cell is marked, false otherwise
-bool Cell::markUnmarkedNeighboursAsSafe()
-{
-    bool changeOccured = false;
-
-    for (int i = 0; i < m_neighbourAmount; i++) {
-        if(!m_neighbourCells[i]->m_isMarkedUnsafe && !m_neighbourCells[i]->m_isRevealed && !m_neighbourCells[i]->m_isMarkedSafe) {
-            m_neighbourCells[i]->m_isMarkedSafe = true;
-            changeOccured = true;
-        }
-    }
-
-    return changeOccured;
 }
 
 
 // This function is called whenever a cell is right clicked
-// Flags the cell
+// Flags the cell, or unflags it if it's previously flagged
 void Cell::flagCell() {
 
-    // If the cell is not flagged, flag it.
-    if(!m_isFlagged) {
+    // Buttons don't respond once the game is over
+    if (m_board->status() != GameStatus::Playing)
+        return;
 
+    m_board->flagCell(m_index);
 
-        m_isFlagged = true;
+    if (m_board->isFlagged(m_index)) {
         m_cellButton->setIcon(QIcon(":/image/flag.png"));
-
-        // If the cell is suggested as a hint, flagging should make it unsuggested
-        if(m_isHinted) {
-            m_isHinted = false;
-        }
     }
-    // Unflag it if it's previously flagged
     else {
-        m_isFlagged = false;
         m_cellButton->setIcon(QIcon(":/image/empty.png"));
     }
 }
@@ -0,0 +1,118 @@
+#include "concurrentboard.h"
+
+/*
+ * This file provides implementations for the member functions of ConcurrentBoard class declared in concurrentboard.h
+ */
+
+// Copies the layout, the board is not shared with any thread yet so plain stores are enough
+ConcurrentBoard::ConcurrentBoard(const Board& layout)
+    : m_topology{layout.topology()}
+    , m_cells{new std::atomic<std::uint32_t>[std::size_t(layout.topology().cellAmount())]}
+    , m_mineAmount{layout.mineAmount()}
+{
+    for (int i = 0; i < m_topology.cellAmount(); i++) {
+        std::uint32_t word = std::uint32_t(layout.numberOfNeighbouringMines(i)) << NumberShift;
+        if (layout.isMine(i))
+            word |= Mine;
+        m_cells[i].store(word, std::memory_order_relaxed);
+    }
+}
+
+/*
+ * The compare-and-swap only succeeds on a cell that is still unrevealed, so of all the threads reaching
+ * a cell at the same time exactly one claims it, the player bits are set by the same swap
+ */
+bool ConcurrentBoard::claim(int index, std::uint32_t playerBits)
+{
+    std::uint32_t word = m_cells[index].load(std::memory_order_relaxed);
+    do {
+        if (word & Revealed)
+            return false;
+    } while (!m_cells[index].compare_exchange_weak(word, word | Revealed | playerBits,
+                                                   std::memory_order_acq_rel, std::memory_order_relaxed));
+    return true;
+}
+
+void ConcurrentBoard::endGame(GameStatus status)
+{
+    int playing = int(GameStatus::Playing);
+    m_status.compare_exchange_strong(playing, int(status), std::memory_order_acq_rel);
+}
+
+/*
+ * Same cascade as Board::reveal(), a breadth-first walk that uses revealedCells as its queue
+ * A thread only walks on from the cells it claimed itself, so when two cascades meet each of them
+ * stops at the cells of the other one, and together they reveal every cell once
+ */
+GameStatus ConcurrentBoard::reveal(int index, int player, std::vector<int>& revealedCells)
+{
+    if (status() != GameStatus::Playing || !m_topology.isActive(index))
+        return status();
+
+    const std::uint32_t playerBits = (std::uint32_t(player + 1) & 0xffff) << PlayerShift;
+    if (!claim(index, playerBits))
+        return status();
+
+    // If player reveals a mine, the game ends with a lose for everyone
+    if (m_cells[index].load(std::memory_order_relaxed) & Mine) {
+        revealedCells.push_back(index);
+        endGame(GameStatus::Lost);
+        return status();
+    }
+
+    std::size_t first = revealedCells.size();
+    revealedCells.push_back(index);
+
+    for (std::size_t head = first; head < revealedCells.size(); head++) {
+
+        int current = revealedCells[head];
+        if ((m_cells[current].load(std::memory_order_relaxed) >> NumberShift) & 0xf)
+            continue;
+
+        // Neighbours of an empty cell never contain a mine
+        for (const std::uint32_t* n = m_topology.neighboursBegin(current); n != m_topology.neighboursEnd(current); ++n) {
+            if (claim(int(*n), playerBits))
+                revealedCells.push_back(int(*n));
+        }
+    }
+
+    // One update of the shared counter per reveal, the thread that reaches the total ends the game with a win
+    int revealedAmount = int(revealedCells.size() - first);
+    int total = m_revealedCellAmount.fetch_add(revealedAmount, std::memory_order_acq_rel) + revealedAmount;
+    if (total + m_mineAmount == m_topology.activeCellAmount())
+        endGame(GameStatus::Won);
+
+    return status();
+}
+
+bool ConcurrentBoard::flagCell(int index)
+{
+    if (status() != GameStatus::Playing || !m_topology.isActive(index))
+        return false;
+
+    std::uint32_t word = m_cells[index].load(std::memory_order_relaxed);
+    do {
+        if (word & Revealed)
+            return false;
+    } while (!m_cells[index].compare_exchange_weak(word, word ^ Flagged, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    return true;
+}
+
+std::uint8_t ConcurrentBoard::visibleCell(int index) const
+{
+    if (!m_topology.isActive(index))
+        return Board::Hole;
+
+    std::uint32_t word = cell(index);
+    if (word & Revealed)
+        return (word & Mine) ? std::uint8_t(Board::RevealedMine) : std::uint8_t((word >> NumberShift) & 0xf);
+
+    return (word & Flagged) ? std::uint8_t(Board::FlaggedCell) : std::uint8_t(Board::Hidden);
+}
+
+void ConcurrentBoard::copyVisibleState(std::uint8_t* visibleState) const
+{
+    for (int i = 0; i < m_topology.cellAmount(); i++)
+        visibleState[i] = visibleCell(i);
+}
@@ -0,0 +1,74 @@
+#ifndef CONCURRENTBOARD_H
+#define CONCURRENTBOARD_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "board.h"
+#include "topology.h"
+
+/*
+ * Game state of a board shared by several players (or bots) playing at the same time, from different threads
+ *
+ * Every cell is one atomic word, all changes to it are made with compare-and-swap:
+ *   bits 0 ... 2    Mine, Revealed, Flagged
+ *   bits 8 ... 11   number of neighbouring mines, written once before the game starts
+ *   bits 16 ... 31  player who revealed the cell, plus one (0 while unrevealed)
+ *
+ * A reveal claims a cell by setting its Revealed bit, only the thread whose compare-and-swap succeeds goes on
+ * with the cell, so each cell is revealed exactly once even when the cascades of several players meet
+ * The revealed cell counter is atomic too and is updated once per reveal, there is no lock anywhere
+ *
+ * Mines are placed with a Board (generateMines / setMine, setMineNumbers) and copied on construction
+ * The rules are those of Board::reveal() and Board::flagCell(), hints are not part of the co-op mode
+ */
+class ConcurrentBoard
+{
+public:
+    enum CellBit : std::uint32_t {
+        Mine     = 1 << 0,
+        Revealed = 1 << 1,
+        Flagged  = 1 << 2
+    };
+
+    explicit ConcurrentBoard(const Board& layout);      // Takes the topology, the mines and the numbers of the board
+
+    const Topology& topology() const { return m_topology; }
+
+    // Player actions, safe to call from any thread at any time
+    // Cells revealed by this call are appended to revealedCells in reveal order
+    GameStatus reveal(int index, int player, std::vector<int>& revealedCells);
+    bool flagCell(int index);                           // Flags or unflags the cell, returns false if it is revealed
+
+    // Cell queries, a cell may change right after it is read
+    bool isMine(int index) const { return cell(index) & Mine; }
+    bool isRevealed(int index) const { return cell(index) & Revealed; }
+    bool isFlagged(int index) const { return cell(index) & Flagged; }
+    int numberOfNeighbouringMines(int index) const { return int((cell(index) >> NumberShift) & 0xf); }
+    int revealedBy(int index) const { return int(cell(index) >> PlayerShift) - 1; }    // Player who revealed the cell, -1 if unrevealed
+    std::uint8_t visibleCell(int index) const;          // Board::VisibleCell code of the cell
+    void copyVisibleState(std::uint8_t* visibleState) const;   // Code of every cell, cellAmount() bytes
+
+    // Game queries
+    GameStatus status() const { return GameStatus(m_status.load(std::memory_order_acquire)); }
+    int mineAmount() const { return m_mineAmount; }
+    int revealedCellAmount() const { return m_revealedCellAmount.load(std::memory_order_relaxed); }
+
+private:
+    static const int NumberShift = 8;
+    static const int PlayerShift = 16;
+
+    std::uint32_t cell(int index) const { return m_cells[index].load(std::memory_order_acquire); }
+    bool claim(int index, std::uint32_t playerBits);   // Sets the Revealed bit, returns false if another reveal got there first
+    void endGame(GameStatus status);                    // Leaves Playing for the given status, only the first call has an effect
+
+    Topology m_topology;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> m_cells;     // One word per cell, see the layout above
+
+    std::atomic<int> m_status{int(GameStatus::Playing)};
+    std::atomic<int> m_revealedCellAmount{0};                   // Revealed non-mine cells
+    int m_mineAmount = 0;
+};
+
+#endif // CONCURRENTBOARD_H
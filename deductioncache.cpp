@@ -0,0 +1,219 @@
+#include "deductioncache.h"
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+
+/*
+ * This file provides implementations for the local pattern solver and the DeductionCache class declared in deductioncache.h
+ */
+
+#define DEDUCTION_MIN_CACHE_BITS 4
+#define DEDUCTION_MAX_CACHE_BITS 24
+
+namespace {
+
+std::atomic<int> sharedCapacityBits{DEDUCTION_SHARED_CACHE_BITS};
+
+int clampCapacityBits(int capacityBits)
+{
+    return std::min(std::max(capacityBits, DEDUCTION_MIN_CACHE_BITS), DEDUCTION_MAX_CACHE_BITS);
+}
+
+// Offsets of the 8 neighbours, in the order used by LocalDeduction bits
+const int neighbourRowOffsets[8]    = {-1, -1, -1,  0, 0,  1, 1, 1};
+const int neighbourColumnOffsets[8] = {-1,  0,  1, -1, 1, -1, 0, 1};
+
+// Random keys of the Zobrist hash, one per position and code, generated once with splitmix64
+struct ZobristTable
+{
+    std::uint64_t keys[PATTERN_SIZE][16];
+
+    ZobristTable()
+    {
+        std::uint64_t state = 0x6d696e6573776565ull;
+        for (int i = 0; i < PATTERN_SIZE; i++) {
+            for (int j = 0; j < 16; j++) {
+                state += 0x9e3779b97f4a7c15ull;
+                std::uint64_t z = state;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+                keys[i][j] = z ^ (z >> 31);
+            }
+        }
+    }
+};
+
+const ZobristTable& zobristTable()
+{
+    static const ZobristTable table;
+    return table;
+}
+
+// A constraint of one revealed number, restricted to the neighbours of the centre
+struct Constraint
+{
+    std::uint8_t variables;     // Bits of the centre's unknown neighbours that are also neighbours of the number
+    int minimumMines;           // The variables hold at least this many mines...
+    int maximumMines;           // ...and at most this many, the rest can be on unknown cells outside the centre's neighbourhood
+};
+
+} // namespace
+
+/*
+ * Decides which unknown neighbours of the centre are certainly safe or certainly mined
+ * Every revealed number within distance 2 of the centre shares neighbours with the centre,
+ * each of them limits how many mines the shared unknown cells can hold
+ * All 2^(unknown neighbours) assignments are checked against these limits,
+ * a neighbour that is empty (or mined) in every consistent assignment is certainly safe (or mined)
+ */
+LocalDeduction solveLocalPattern(const LocalPattern& pattern)
+{
+    LocalDeduction deduction;
+
+    int centreRow = PATTERN_SIDE / 2;
+    int centreColumn = PATTERN_SIDE / 2;
+
+    // Map the position of each unknown neighbour of the centre to its bit
+    int variableBits[PATTERN_SIZE] = {};
+    int variableAmount = 0;
+    for (int k = 0; k < 8; k++) {
+        int position = (centreRow + neighbourRowOffsets[k]) * PATTERN_SIDE + centreColumn + neighbourColumnOffsets[k];
+        if (pattern[position] == PatternUnknown) {
+            variableBits[position] = 1 << k;
+            variableAmount++;
+        }
+    }
+
+    if (variableAmount == 0)
+        return deduction;
+
+    // Collect the constraints of the numbers in the inner 5x5 window
+    Constraint constraints[25];
+    int constraintAmount = 0;
+    for (int row = centreRow - 2; row <= centreRow + 2; row++) {
+        for (int column = centreColumn - 2; column <= centreColumn + 2; column++) {
+
+            int number = pattern[row * PATTERN_SIDE + column];
+            if (number > 8)
+                continue;
+
+            int variables = 0;
+            int knownMines = 0;
+            int otherUnknowns = 0;
+            for (int k = 0; k < 8; k++) {
+                int position = (row + neighbourRowOffsets[k]) * PATTERN_SIDE + column + neighbourColumnOffsets[k];
+                if (variableBits[position])
+                    variables |= variableBits[position];
+                else if (pattern[position] == PatternMine)
+                    knownMines++;
+                else if (pattern[position] == PatternUnknown)
+                    otherUnknowns++;
+            }
+
+            if (variables == 0)
+                continue;
+
+            int remainingMines = number - knownMines;
+            constraints[constraintAmount++] = { std::uint8_t(variables), remainingMines - otherUnknowns, remainingMines };
+        }
+    }
+
+    // Try every assignment of mines to the unknown neighbours
+    std::uint8_t alwaysMine = 0xff;
+    std::uint8_t neverMine = 0xff;
+    bool isConsistent = false;
+
+    int allVariables = 0;
+    for (int k = 0; k < 8; k++)
+        allVariables |= variableBits[(centreRow + neighbourRowOffsets[k]) * PATTERN_SIDE + centreColumn + neighbourColumnOffsets[k]];
+
+    for (int assignment = allVariables; ; assignment = (assignment - 1) & allVariables) {
+
+        bool isValid = true;
+        for (int i = 0; i < constraintAmount && isValid; i++) {
+            int mines = int(std::bitset<8>(assignment & constraints[i].variables).count());
+            isValid = mines >= constraints[i].minimumMines && mines <= constraints[i].maximumMines;
+        }
+
+        if (isValid) {
+            isConsistent = true;
+            alwaysMine &= std::uint8_t(assignment);
+            neverMine &= std::uint8_t(~assignment);
+        }
+
+        if (assignment == 0)
+            break;
+    }
+
+    // A contradiction means the marks around the pattern are wrong, conclude nothing
+    if (!isConsistent)
+        return deduction;
+
+    deduction.mineNeighbours = alwaysMine & std::uint8_t(allVariables);
+    deduction.safeNeighbours = neverMine & std::uint8_t(allVariables);
+    return deduction;
+}
+
+// Allocates the table, capacityBits is clamped to keep the table between 2^4 and 2^24 entries
+DeductionCache::DeductionCache(int capacityBits)
+{
+    capacityBits = clampCapacityBits(capacityBits);
+    m_entries.resize(std::size_t(1) << capacityBits);
+    m_mask = (std::uint64_t(1) << capacityBits) - 1;
+}
+
+// Each thread gets its own cache, so boards played on different threads never wait for each other
+DeductionCache& DeductionCache::shared()
+{
+    int capacityBits = sharedCapacityBits.load(std::memory_order_relaxed);
+    thread_local DeductionCache cache(capacityBits);
+    if (cache.capacity() != 1 << capacityBits)
+        cache = DeductionCache(capacityBits);
+    return cache;
+}
+
+void DeductionCache::setSharedCapacityBits(int capacityBits)
+{
+    sharedCapacityBits.store(clampCapacityBits(capacityBits), std::memory_order_relaxed);
+}
+
+std::uint64_t DeductionCache::hash(const LocalPattern& pattern)
+{
+    const ZobristTable& table = zobristTable();
+
+    std::uint64_t key = 0;
+    for (int i = 0; i < PATTERN_SIZE; i++) {
+        key ^= table.keys[i][pattern[i]];
+    }
+
+    return key;
+}
+
+LocalDeduction DeductionCache::deduce(const LocalPattern& pattern)
+{
+    std::uint64_t key = hash(pattern);
+    Entry& entry = m_entries[key & m_mask];
+
+    if (entry.isValid && entry.key == key && entry.pattern == pattern) {
+        m_statistics.hits++;
+        return entry.deduction;
+    }
+
+    m_statistics.misses++;
+    if (entry.isValid)
+        m_statistics.evictions++;
+
+    entry.key = key;
+    entry.pattern = pattern;
+    entry.deduction = solveLocalPattern(pattern);
+    entry.isValid = true;
+
+    return entry.deduction;
+}
+
+void DeductionCache::clear()
+{
+    for (Entry& entry : m_entries) {
+        entry.isValid = false;
+    }
+}
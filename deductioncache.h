@@ -0,0 +1,88 @@
+#ifndef DEDUCTIONCACHE_H
+#define DEDUCTIONCACHE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Local deductions of the hint algorithm and the cache that remembers them
+ *
+ * A local pattern is the 7x7 window around a revealed cell, as the player knows it:
+ * numbers of revealed cells, unknown cells, cells already deduced as mine or safe, and positions outside the board
+ * Solving the pattern decides which of the 8 neighbours of the centre are certainly safe or certainly mined,
+ * using every number in the inner 5x5 window whose neighbours overlap the neighbours of the centre
+ *
+ * The same patterns recur constantly within and across games, so their conclusions are stored in a
+ * bounded table keyed by a Zobrist hash of the pattern
+ */
+
+#define PATTERN_SIDE 7                                  // Width and height of the window
+#define PATTERN_SIZE (PATTERN_SIDE * PATTERN_SIDE)      // Number of positions in the window
+#define PATTERN_CENTRE (PATTERN_SIZE / 2)               // Position of the centre cell
+
+#define DEDUCTION_CACHE_BITS 16                         // Default capacity of a cache made for a board, 2^bits patterns of 64 bytes
+#define DEDUCTION_SHARED_CACHE_BITS 12                  // Default capacity of the cache of each thread, 256 KB
+
+// Codes used in a local pattern, 0 ... 8 is a revealed cell showing its number
+enum PatternCell : std::uint8_t {
+    PatternUnknown = 9,        // Unrevealed cell, nothing is known about it
+    PatternMine    = 10,       // Unrevealed cell that is certain to contain a mine
+    PatternSafe    = 11,       // Unrevealed cell that is certain to not contain a mine
+    PatternOutside = 12        // Not a cell of the board (edge or hole)
+};
+
+typedef std::array<std::uint8_t, PATTERN_SIZE> LocalPattern;
+
+// Conclusions about the 8 neighbours of the centre, bit k belongs to the k-th neighbour
+// Neighbours are ordered row by row: (-1,-1) (-1,0) (-1,1) (0,-1) (0,1) (1,-1) (1,0) (1,1)
+struct LocalDeduction
+{
+    std::uint8_t safeNeighbours = 0;
+    std::uint8_t mineNeighbours = 0;
+};
+
+LocalDeduction solveLocalPattern(const LocalPattern& pattern);    // Enumerates the assignments of the unknown neighbours of the centre
+
+class DeductionCache
+{
+public:
+    struct Statistics
+    {
+        std::uint64_t hits = 0;         // Lookups answered from the table
+        std::uint64_t misses = 0;       // Lookups that had to solve the pattern
+        std::uint64_t evictions = 0;    // Stored patterns that replaced a different pattern
+    };
+
+    explicit DeductionCache(int capacityBits = DEDUCTION_CACHE_BITS);  // Holds 2^capacityBits patterns
+
+    // Cache of the calling thread, used by boards without a cache of their own
+    // Every thread that asks for a hint gets one, so it is smaller than a cache made for a board
+    static DeductionCache& shared();
+    // Capacity of the thread caches, a thread cache of another capacity is emptied and resized by its next shared()
+    static void setSharedCapacityBits(int capacityBits);
+
+    LocalDeduction deduce(const LocalPattern& pattern);     // Returns the conclusions from the table, solves and stores them on a miss
+
+    const Statistics& statistics() const { return m_statistics; }
+    void resetStatistics() { m_statistics = Statistics(); }
+    void clear();                                           // Forgets every stored pattern
+    int capacity() const { return int(m_entries.size()); }
+
+    static std::uint64_t hash(const LocalPattern& pattern); // Zobrist hash, XOR of a random key per (position, code)
+
+private:
+    struct Entry
+    {
+        std::uint64_t key = 0;
+        LocalPattern pattern;           // Stored to tell apart patterns whose hashes collide
+        LocalDeduction deduction;
+        bool isValid = false;
+    };
+
+    std::vector<Entry> m_entries;       // Direct-mapped table, a new pattern replaces the one in its slot
+    std::uint64_t m_mask;
+    Statistics m_statistics;
+};
+
+#endif // DEDUCTIONCACHE_H
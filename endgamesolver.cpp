@@ -0,0 +1,530 @@
+#include "endgamesolver.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#define ENDGAME_CLOCK_NODES 1024        // Positions searched between two looks at the clock and the cancel flag
+#define ENDGAME_MIN_TABLE_BITS 10       // Smallest transposition table, 2^bits entries
+
+/*
+ * This file provides implementations for the member functions of EndgameSolver class declared in endgamesolver.h
+ */
+
+namespace {
+
+typedef std::uint64_t Layout;           // Bit u is set when unknown cell u holds a mine (also used for sets of unknown cells)
+typedef std::chrono::steady_clock Clock;
+
+int bitCount(Layout cells)
+{
+    return int(std::bitset<64>(cells).count());
+}
+
+// Index of the lowest set bit: the bits below it are set by cells - 1 and counted, cells must not be 0
+int lowestBit(Layout cells)
+{
+    return bitCount((cells & (~cells + 1)) - 1);
+}
+
+// splitmix64 finalizer, turns a layout into the random-looking key of the Zobrist hash
+std::uint64_t mix(std::uint64_t z)
+{
+    z += 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Threads of a solve, one per core
+// Asking the system for the core count is a system call, so it is asked once
+int coreAmount()
+{
+    static const int amount = std::max(1, int(std::thread::hardware_concurrency()));
+    return amount;
+}
+
+// A revealed number next to the unknown region
+struct NumberConstraint
+{
+    Layout cells;                       // Its unknown neighbours
+    int mines;                          // Mines among them
+};
+
+// The unknown cells, numbered 0 ... cellAmount - 1 in board order, certain mines are not part of it
+struct Region
+{
+    std::vector<int> cells;             // Board index of each unknown cell
+    std::vector<Layout> neighbours;     // Unknown neighbours of each unknown cell
+    std::vector<int> knownMines;        // Neighbours of each unknown cell that are certain mines, left out of the region
+    std::vector<NumberConstraint> constraints;
+    std::vector<std::vector<int>> constraintsOf;    // Constraints that contain each unknown cell
+    int mineAmount = 0;
+};
+
+/*
+ * Lists every layout of the region that fits the revealed numbers and the mine amount
+ * Cells are assigned in order, a branch stops as soon as a number has too many mines or can't get enough
+ * Returns false if there are more than maxLayouts layouts
+ */
+class LayoutEnumerator
+{
+public:
+    LayoutEnumerator(const Region& region, std::size_t maxLayouts, std::vector<Layout>& layouts)
+        : m_region{region}, m_maxLayouts{maxLayouts}, m_layouts{layouts} {}
+
+    bool run()
+    {
+        m_isOverLimit = false;
+        assign(0, 0, m_region.mineAmount);
+        return !m_isOverLimit;
+    }
+
+private:
+    const Region& m_region;
+    const std::size_t m_maxLayouts;
+    std::vector<Layout>& m_layouts;
+    bool m_isOverLimit = false;
+
+    bool fits(int cell, Layout layout) const
+    {
+        Layout unassigned = cell + 1 < 64 ? ~((Layout(2) << cell) - 1) : 0;
+        for (int constraint : m_region.constraintsOf[std::size_t(cell)]) {
+            const NumberConstraint& number = m_region.constraints[std::size_t(constraint)];
+            int placed = bitCount(layout & number.cells);
+            if (placed > number.mines || placed + bitCount(number.cells & unassigned) < number.mines)
+                return false;
+        }
+        return true;
+    }
+
+    void assign(int cell, Layout layout, int minesLeft)
+    {
+        if (m_isOverLimit)
+            return;
+
+        int cellsLeft = int(m_region.cells.size()) - cell;
+        if (cellsLeft == 0) {
+            if (m_layouts.size() == m_maxLayouts)
+                m_isOverLimit = true;
+            else
+                m_layouts.push_back(layout);
+            return;
+        }
+
+        if (minesLeft < cellsLeft && fits(cell, layout))
+            assign(cell + 1, layout, minesLeft);
+
+        Layout mined = layout | (Layout(1) << cell);
+        if (minesLeft > 0 && fits(cell, mined))
+            assign(cell + 1, mined, minesLeft - 1);
+    }
+};
+
+// What opening a cell shows in one layout: the cells it opens and their numbers
+struct Outcome
+{
+    Layout opened;
+    std::array<std::uint64_t, 4> numbers;   // 4 bits per unknown cell, only opened cells are set
+    Layout layout;
+
+    bool isSameView(const Outcome& other) const { return opened == other.opened && numbers == other.numbers; }
+    bool operator<(const Outcome& other) const
+    {
+        return opened != other.opened ? opened < other.opened : numbers < other.numbers;
+    }
+};
+
+// Position already searched, the revealed cells and the layout amount tell apart most keys that collide
+struct TableEntry
+{
+    std::uint64_t key = 0;
+    Layout revealed = 0;
+    std::uint32_t layoutAmount = 0;     // 0 for an empty entry
+    std::uint32_t wins = 0;
+};
+
+/*
+ * Expectimax search of one thread
+ * A position is the set of layouts still possible and the revealed unknown cells, it is worth the number of
+ * its layouts won by optimal play. Each depth has its own buffers, so the search doesn't allocate once warm
+ */
+class Searcher
+{
+public:
+    Searcher(const Region& region, int tableBits, Clock::time_point deadline, const std::atomic<bool>* cancelFlag,
+             std::atomic<bool>& isTimedOut)
+        : m_region{region}
+        , m_table(std::size_t(1) << tableBits)
+        , m_tableMask{(std::uint64_t(1) << tableBits) - 1}
+        , m_outcomes(region.cells.size() + 2)
+        , m_layouts(region.cells.size() + 2)
+        , m_deadline{deadline}
+        , m_cancelFlag{cancelFlag}
+        , m_isTimedOut{isTimedOut} {}
+
+    std::uint64_t nodes() const { return m_nodes; }
+
+    /*
+     * Wins of opening the cell: the layouts are split by what the cell shows, mined layouts are lost
+     * The result is exact when it is above threshold. Otherwise the cell can't beat the threshold and the
+     * split is dropped as soon as its remaining layouts can't lift it above, then the result is some value <= threshold
+     */
+    std::uint32_t openCell(int cell, const Layout* layouts, std::uint32_t layoutAmount, Layout revealed, int depth,
+                           std::uint32_t threshold)
+    {
+        std::vector<Outcome>& outcomes = m_outcomes[std::size_t(depth)];
+        outcomes.clear();
+
+        const Layout cellBit = Layout(1) << cell;
+        for (std::uint32_t i = 0; i < layoutAmount; i++) {
+            if (!(layouts[i] & cellBit))
+                outcomes.push_back(outcomeOf(cell, layouts[i], revealed));
+        }
+        std::sort(outcomes.begin(), outcomes.end());
+
+        // Layouts of each view, one after the other, are the positions reached
+        std::vector<Layout>& children = m_layouts[std::size_t(depth) + 1];
+        children.resize(outcomes.size());
+        for (std::size_t i = 0; i < outcomes.size(); i++)
+            children[i] = outcomes[i].layout;
+
+        std::uint32_t wins = 0;
+        std::uint32_t remaining = std::uint32_t(outcomes.size());
+        for (std::size_t first = 0; first < outcomes.size(); ) {
+            if (wins + remaining <= threshold)
+                return wins + remaining;
+
+            std::size_t last = first + 1;
+            while (last < outcomes.size() && outcomes[last].isSameView(outcomes[first]))
+                last++;
+
+            std::uint32_t amount = std::uint32_t(last - first);
+            wins += search(children.data() + first, amount, revealed | outcomes[first].opened, depth + 1);
+            if (m_isTimedOut.load(std::memory_order_relaxed))
+                return 0;
+
+            remaining -= amount;
+            first = last;
+        }
+
+        return wins;
+    }
+
+private:
+    const Region& m_region;
+    std::vector<TableEntry> m_table;
+    const std::uint64_t m_tableMask;
+    std::vector<std::vector<Outcome>> m_outcomes;   // Views of the layouts of an opened cell, per depth
+    std::vector<std::vector<Layout>> m_layouts;     // Layouts of the positions reached, per depth
+    const Clock::time_point m_deadline;
+    const std::atomic<bool>* m_cancelFlag;          // Stops the search like the deadline, nullptr for none
+    std::atomic<bool>& m_isTimedOut;
+    std::uint64_t m_nodes = 0;
+
+    // Opened cells and numbers, a cell without mine around also opens its unknown neighbours
+    Outcome outcomeOf(int cell, Layout layout, Layout revealed) const
+    {
+        Outcome outcome{0, {}, layout};
+        Layout pending = Layout(1) << cell;
+        while (pending) {
+            int current = lowestBit(pending);
+            pending &= pending - 1;
+            outcome.opened |= Layout(1) << current;
+
+            std::uint64_t number = std::uint64_t(m_region.knownMines[std::size_t(current)]
+                                                 + bitCount(layout & m_region.neighbours[std::size_t(current)]));
+            outcome.numbers[std::size_t(current >> 4)] |= number << ((current & 15) * 4);
+            if (number == 0)
+                pending |= m_region.neighbours[std::size_t(current)] & ~revealed & ~outcome.opened;
+        }
+        return outcome;
+    }
+
+    std::uint32_t search(const Layout* layouts, std::uint32_t layoutAmount, Layout revealed, int depth)
+    {
+        // A single layout is known, every safe cell can be opened
+        if (layoutAmount == 1)
+            return 1;
+
+        if (++m_nodes % ENDGAME_CLOCK_NODES == 0
+            && (Clock::now() > m_deadline || (m_cancelFlag && m_cancelFlag->load(std::memory_order_relaxed))))
+            m_isTimedOut.store(true, std::memory_order_relaxed);
+        if (m_isTimedOut.load(std::memory_order_relaxed))
+            return 0;
+
+        // Mines on each unknown cell, and the Zobrist hash of the position
+        std::array<std::uint32_t, ENDGAME_UNKNOWN_CELLS_LIMIT> mines{};
+        std::uint64_t key = mix(revealed ^ 0x656e6467616d6531ull);
+        for (std::uint32_t i = 0; i < layoutAmount; i++) {
+            key ^= mix(layouts[i]);
+            for (Layout cells = layouts[i]; cells; cells &= cells - 1)
+                mines[std::size_t(lowestBit(cells))]++;
+        }
+
+        TableEntry& entry = m_table[key & m_tableMask];
+        if (entry.key == key && entry.revealed == revealed && entry.layoutAmount == layoutAmount)
+            return entry.wins;
+
+        // Candidates from the safest, a cell safe in every layout is opened alone
+        int candidates[ENDGAME_UNKNOWN_CELLS_LIMIT];
+        int candidateAmount = 0;
+        const Layout unknown = ~revealed & (m_region.cells.size() < 64 ? (Layout(1) << m_region.cells.size()) - 1 : ~Layout(0));
+        for (Layout cells = unknown; cells; cells &= cells - 1) {
+            int cell = lowestBit(cells);
+            if (mines[std::size_t(cell)] == 0) {
+                candidates[0] = cell;
+                candidateAmount = 1;
+                break;
+            }
+            if (mines[std::size_t(cell)] < layoutAmount)
+                candidates[candidateAmount++] = cell;
+        }
+        std::stable_sort(candidates, candidates + candidateAmount, [&mines](int a, int b) {
+            return mines[std::size_t(a)] < mines[std::size_t(b)];
+        });
+
+        std::uint32_t best = 0;
+        for (int i = 0; i < candidateAmount; i++) {
+            int cell = candidates[i];
+            if (layoutAmount - mines[std::size_t(cell)] <= best)
+                break;
+
+            std::uint32_t wins = openCell(cell, layouts, layoutAmount, revealed, depth, best);
+            if (m_isTimedOut.load(std::memory_order_relaxed))
+                return 0;
+            best = std::max(best, wins);
+        }
+
+        entry.key = key;
+        entry.revealed = revealed;
+        entry.layoutAmount = layoutAmount;
+        entry.wins = best;
+        return best;
+    }
+};
+
+} // namespace
+
+void EndgameSolver::setMaxUnknownCells(int cellAmount)
+{
+    m_maxUnknownCells = std::min(std::max(cellAmount, 1), ENDGAME_UNKNOWN_CELLS_LIMIT);
+}
+
+/*
+ * Collects the unknown region, enumerates its layouts and searches the cells of the root on every thread
+ * Threads take the root cells one at a time from the safest, and skip a cell that can't reach the best wins
+ * found so far. A cell that ties the best is still searched, so the guess doesn't depend on thread timing:
+ * the most wins, then the safest, then the first cell
+ */
+EndgameResult EndgameSolver::solve(const Topology& topology, const std::uint8_t* visibleState, int mineAmount) const
+{
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(m_timeBudget);
+    EndgameResult result;
+
+    // Unrevealed cells, flags are not trusted since the player may have misplaced them
+    auto isUnrevealed = [visibleState](int index) {
+        return visibleState[index] == Board::Hidden || visibleState[index] == Board::FlaggedCell
+               || visibleState[index] == Board::HintedCell;
+    };
+
+    int unrevealedAmount = 0;
+    for (int i = 0; i < topology.cellAmount(); i++) {
+        if (visibleState[i] == Board::RevealedMine)
+            return result;
+        if (isUnrevealed(i))
+            unrevealedAmount++;
+    }
+
+    // Only mines are left out of the region
+    if (unrevealedAmount - mineAmount > m_maxUnknownCells) {
+        result.status = EndgameStatus::TooLarge;
+        return result;
+    }
+
+    // Certain mines are left out: a number with as many unrevealed neighbours, not known as mines, as mines left
+    std::vector<std::uint8_t> isKnownMine(std::size_t(topology.cellAmount()), 0);
+    for (bool isChanged = true; isChanged; ) {
+        isChanged = false;
+        for (int i = 0; i < topology.cellAmount(); i++) {
+            if (visibleState[i] > 8)
+                continue;
+
+            int unknownAmount = 0;
+            int knownAmount = 0;
+            for (const std::uint32_t* n = topology.neighboursBegin(i); n != topology.neighboursEnd(i); ++n) {
+                if (isUnrevealed(int(*n)))
+                    (isKnownMine[*n] ? knownAmount : unknownAmount)++;
+            }
+            if (unknownAmount == 0 || visibleState[i] - knownAmount != unknownAmount)
+                continue;
+
+            for (const std::uint32_t* n = topology.neighboursBegin(i); n != topology.neighboursEnd(i); ++n) {
+                if (isUnrevealed(int(*n)))
+                    isKnownMine[*n] = 1;
+            }
+            isChanged = true;
+        }
+    }
+
+    // Unknown cells, in board order
+    Region region;
+    region.mineAmount = mineAmount;
+    std::vector<int> regionIndex(std::size_t(topology.cellAmount()), -1);
+    for (int i = 0; i < topology.cellAmount(); i++) {
+        if (isKnownMine[std::size_t(i)])
+            region.mineAmount--;
+        else if (isUnrevealed(i)) {
+            regionIndex[std::size_t(i)] = int(region.cells.size());
+            region.cells.push_back(i);
+        }
+    }
+
+    result.unknownCellAmount = int(region.cells.size());
+    if (region.cells.empty() || region.mineAmount < 0 || region.mineAmount > int(region.cells.size()))
+        return result;
+    if (int(region.cells.size()) > m_maxUnknownCells) {
+        result.status = EndgameStatus::TooLarge;
+        return result;
+    }
+
+    region.neighbours.assign(region.cells.size(), 0);
+    region.knownMines.assign(region.cells.size(), 0);
+    region.constraintsOf.resize(region.cells.size());
+    for (std::size_t u = 0; u < region.cells.size(); u++) {
+        for (const std::uint32_t* n = topology.neighboursBegin(region.cells[u]); n != topology.neighboursEnd(region.cells[u]); ++n) {
+            if (regionIndex[*n] >= 0)
+                region.neighbours[u] |= Layout(1) << regionIndex[*n];
+            else if (isKnownMine[*n])
+                region.knownMines[u]++;
+        }
+    }
+
+    // Every revealed number next to the region, numbers with no unknown neighbour must be satisfied already
+    for (int i = 0; i < topology.cellAmount(); i++) {
+        if (visibleState[i] > 8)
+            continue;
+
+        NumberConstraint constraint{0, visibleState[i]};
+        for (const std::uint32_t* n = topology.neighboursBegin(i); n != topology.neighboursEnd(i); ++n) {
+            if (regionIndex[*n] >= 0)
+                constraint.cells |= Layout(1) << regionIndex[*n];
+            else if (isKnownMine[*n])
+                constraint.mines--;
+        }
+        if (constraint.mines < 0 || (!constraint.cells && constraint.mines != 0))
+            return result;
+        if (!constraint.cells)
+            continue;
+
+        for (Layout cells = constraint.cells; cells; cells &= cells - 1)
+            region.constraintsOf[std::size_t(lowestBit(cells))].push_back(int(region.constraints.size()));
+        region.constraints.push_back(constraint);
+    }
+
+    // Half of the memory budget holds the layouts with the search buffers of the top two depths,
+    // deeper positions hold few layouts. The other half is the transposition tables
+    int threadAmount = std::min(m_threadAmount > 0 ? m_threadAmount : coreAmount(), ENDGAME_MAX_THREADS);
+    std::size_t bytesPerLayout = sizeof(Layout) + std::size_t(threadAmount) * 2 * (sizeof(Outcome) + sizeof(Layout));
+    std::size_t maxLayouts = std::min<std::size_t>(m_memoryBudget / 2 / bytesPerLayout, UINT32_MAX);
+
+    std::vector<Layout> layouts;
+    if (!LayoutEnumerator(region, maxLayouts, layouts).run()) {
+        result.status = EndgameStatus::TooLarge;
+        return result;
+    }
+    result.layoutAmount = layouts.size();
+    if (layouts.empty())
+        return result;
+
+    // Root cells from the safest, a cell safe in every layout is the only one
+    const std::uint32_t layoutAmount = std::uint32_t(layouts.size());
+    std::vector<std::uint32_t> mines(region.cells.size(), 0);
+    for (Layout layout : layouts) {
+        for (Layout cells = layout; cells; cells &= cells - 1)
+            mines[std::size_t(lowestBit(cells))]++;
+    }
+
+    std::vector<int> candidates;
+    for (int u = 0; u < int(region.cells.size()); u++) {
+        if (mines[std::size_t(u)] == 0) {
+            candidates.assign(1, u);
+            break;
+        }
+        if (mines[std::size_t(u)] < layoutAmount)
+            candidates.push_back(u);
+    }
+    if (candidates.empty())
+        return result;
+    std::stable_sort(candidates.begin(), candidates.end(), [&mines](int a, int b) {
+        return mines[std::size_t(a)] < mines[std::size_t(b)];
+    });
+
+    threadAmount = std::min(threadAmount, int(candidates.size()));
+    std::size_t tableBytes = m_memoryBudget / 2 / std::size_t(threadAmount);
+    int tableBits = ENDGAME_MIN_TABLE_BITS;
+    std::size_t usefulEntries = std::size_t(layoutAmount) * region.cells.size();
+    while ((sizeof(TableEntry) << (tableBits + 1)) <= tableBytes && (std::size_t(1) << tableBits) < usefulEntries && tableBits < 40)
+        tableBits++;
+
+    // Wins of each root cell, -1 if it was skipped or not finished in time
+    std::vector<long long> wins(candidates.size(), -1);
+    std::atomic<std::uint32_t> bestWins{0};
+    std::atomic<std::size_t> nextCandidate{0};
+    std::atomic<bool> isTimedOut{false};
+    std::atomic<std::uint64_t> nodes{0};
+
+    auto work = [&]() {
+        Searcher searcher(region, tableBits, deadline, m_cancelFlag, isTimedOut);
+        for (std::size_t i = nextCandidate++; i < candidates.size() && !isTimedOut.load(); i = nextCandidate++) {
+            int cell = candidates[i];
+            std::uint32_t best = bestWins.load();
+            if (layoutAmount - mines[std::size_t(cell)] < best)
+                continue;
+
+            // Exact when the cell ties the best
+            std::uint32_t threshold = best > 0 ? best - 1 : 0;
+            std::uint32_t cellWins = searcher.openCell(cell, layouts.data(), layoutAmount, 0, 0, threshold);
+            if (isTimedOut.load())
+                break;
+            if (cellWins <= threshold && best > 0)
+                continue;
+
+            wins[i] = cellWins;
+            while (cellWins > best && !bestWins.compare_exchange_weak(best, cellWins)) {}
+        }
+        nodes += searcher.nodes();
+    };
+
+    std::vector<std::thread> threads;
+    for (int thread = 1; thread < threadAmount; thread++)
+        threads.emplace_back(work);
+    work();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // A cancelled search is dropped, even if it finished some cells
+    if (m_cancelFlag && m_cancelFlag->load()) {
+        result.status = EndgameStatus::Cancelled;
+        return result;
+    }
+
+    // Candidates are in guess order, the first with the most wins is the guess
+    // If no cell was finished in time that is the first one, the safest
+    std::size_t guess = 0;
+    for (std::size_t i = 0; i < candidates.size(); i++) {
+        if (wins[i] > wins[guess])
+            guess = i;
+    }
+
+    result.status = isTimedOut.load() ? EndgameStatus::TimedOut : EndgameStatus::Solved;
+    result.cell = region.cells[std::size_t(candidates[guess])];
+    result.winProbability = wins[guess] > 0 ? double(wins[guess]) / layoutAmount : 0.0;
+    result.isWinProbabilityKnown = wins[guess] >= 0;
+    result.safeProbability = double(layoutAmount - mines[std::size_t(candidates[guess])]) / layoutAmount;
+    result.nodes = nodes.load();
+    return result;
+}
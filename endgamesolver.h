@@ -0,0 +1,87 @@
+#ifndef ENDGAMESOLVER_H
+#define ENDGAMESOLVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "board.h"
+#include "topology.h"
+
+#define ENDGAME_UNKNOWN_CELLS 20                // Default size of the unknown region searched by the solver
+#define ENDGAME_UNKNOWN_CELLS_LIMIT 64          // Largest unknown region, a layout is one 64-bit mask
+#define ENDGAME_TIME_BUDGET_MS 500              // Default time budget of one solve
+#define ENDGAME_MEMORY_BUDGET (64 << 20)        // Default memory budget of one solve in bytes
+#define ENDGAME_MAX_THREADS 64
+
+/*
+ * Optimal play at the end of a game, when no cell is certainly safe and a guess has to be made
+ *
+ * The unknown region is every unrevealed cell that the revealed numbers don't prove to be a mine, flags are
+ * not trusted since the player may have misplaced them
+ * Once it has at most maxUnknownCells() cells, every mine layout of the region consistent with the revealed
+ * numbers and the mine amount is enumerated, all of them are equally likely
+ *
+ * An expectimax search then plays every unknown cell in every reachable position: opening a cell splits the
+ * layouts by what the cell shows (a mine, or the cells and numbers opened by it), a position is worth the
+ * number of its layouts that are won by playing on optimally
+ * - a cell that is safe in every layout of a position is opened without trying the others, it can't hurt
+ * - cells are tried from the safest, a cell is dropped once its safe layouts can't beat the best cell
+ * - positions reached through different move orders are found in a transposition table keyed by a Zobrist
+ *   hash of the remaining layouts and the revealed cells
+ * - the cells of the root are split over the threads, each with its own table
+ *
+ * Positions are worth whole numbers of layouts, so the win probabilities are exact
+ * The enumeration, the search tables and the time are bounded by the budgets, a search that runs out of time
+ * returns the best of the cells it finished, or the safest cell if it finished none
+ * A solve blocks the calling thread for up to the time budget, or until the cancel flag is set
+ */
+
+enum class EndgameStatus {
+    Solved,         // Every candidate cell was searched, the guess is optimal
+    TimedOut,       // The time budget ran out, the guess is the best cell searched so far, or the safest cell
+    TooLarge,       // Too many unknown cells, or too many layouts for the memory budget
+    NoLayout,       // The game is over, or no layout fits the visible state
+    Cancelled       // The cancel flag was set during the solve, there is no guess
+};
+
+struct EndgameResult
+{
+    EndgameStatus status = EndgameStatus::NoLayout;
+    int cell = -1;                      // Cell to open, -1 unless Solved or TimedOut
+    double winProbability = 0;          // Chance to win by opening the cell and playing on optimally, a lower bound if TimedOut
+    bool isWinProbabilityKnown = false; // False if the search timed out before finishing any cell, winProbability is 0 then
+    double safeProbability = 0;         // Chance that the cell is safe
+    int unknownCellAmount = 0;
+    std::uint64_t layoutAmount = 0;     // Layouts consistent with the visible state
+    std::uint64_t nodes = 0;            // Positions searched
+};
+
+class EndgameSolver
+{
+public:
+    EndgameSolver() = default;
+
+    void setMaxUnknownCells(int cellAmount);                // Clamped to ENDGAME_UNKNOWN_CELLS_LIMIT
+    int maxUnknownCells() const { return m_maxUnknownCells; }
+    void setTimeBudget(int milliseconds) { m_timeBudget = milliseconds; }
+    int timeBudget() const { return m_timeBudget; }
+    void setMemoryBudget(std::size_t bytes) { m_memoryBudget = bytes; }
+    std::size_t memoryBudget() const { return m_memoryBudget; }
+    void setThreadAmount(int threadAmount) { m_threadAmount = threadAmount; }   // 0 uses every core
+
+    // A solve stops soon after *flag becomes true, the flag is owned by the caller, nullptr for none
+    void setCancelFlag(const std::atomic<bool>* flag) { m_cancelFlag = flag; }
+
+    // Uses only what the player can see: the visible state and the total mine amount
+    EndgameResult solve(const Topology& topology, const std::uint8_t* visibleState, int mineAmount) const;
+    EndgameResult solve(const Board& board) const { return solve(board.topology(), board.visibleState(), board.mineAmount()); }
+
+private:
+    int m_maxUnknownCells = ENDGAME_UNKNOWN_CELLS;
+    int m_timeBudget = ENDGAME_TIME_BUDGET_MS;
+    std::size_t m_memoryBudget = ENDGAME_MEMORY_BUDGET;
+    int m_threadAmount = 0;
+    const std::atomic<bool>* m_cancelFlag = nullptr;
+};
+
+#endif // ENDGAMESOLVER_H
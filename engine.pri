@@ -0,0 +1,26 @@
+# Game logic shared by the GUI, the C API library and the tools
+# It doesn't depend on Qt, so it can be built into non-Qt targets
+
+# Giant cascades of Board::reveal() run on std::thread
+CONFIG += thread
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/board.cpp \
+    $$PWD/concurrentboard.cpp \
+    $$PWD/deductioncache.cpp \
+    $$PWD/endgamesolver.cpp \
+    $$PWD/hintsweep.cpp \
+    $$PWD/hintsweep_avx2.cpp \
+    $$PWD/topology.cpp
+
+HEADERS += \
+    $$PWD/board.h \
+    $$PWD/concurrentboard.h \
+    $$PWD/deductioncache.h \
+    $$PWD/endgamesolver.h \
+    $$PWD/hintsweep.h \
+    $$PWD/hintsweep_kernel.h \
+    $$PWD/topology.h
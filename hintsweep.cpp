@@ -0,0 +1,332 @@
+#include "hintsweep.h"
+#include "hintsweep_kernel.h"
+#include "board.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HINTSWEEP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(HINTSWEEP_SSE2) && (defined(__GNUC__) || defined(_MSC_VER))
+#define HINTSWEEP_AVX2 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+/*
+ * This file provides implementations for the member functions of HintSweep class declared in hintsweep.h
+ * together with the plain 64-bit and SSE2 versions of the word loops
+ */
+
+namespace {
+
+// One 64-bit word at a time, works on every processor
+struct ScalarVector
+{
+    typedef std::uint64_t Type;
+    static const int Width = 1;
+
+    static Type load(const std::uint64_t* p) { return *p; }
+    static void store(std::uint64_t* p, Type a) { *p = a; }
+    static Type zero() { return 0; }
+    static Type bitAnd(Type a, Type b) { return a & b; }
+    static Type bitOr(Type a, Type b) { return a | b; }
+    static Type bitXor(Type a, Type b) { return a ^ b; }
+    static Type bitAndNot(Type a, Type b) { return ~a & b; }
+    static Type shiftLeft1(Type a) { return a << 1; }
+    static Type shiftRight1(Type a) { return a >> 1; }
+    static Type shiftLeft63(Type a) { return a << 63; }
+    static Type shiftRight63(Type a) { return a >> 63; }
+    static bool isZero(Type a) { return a == 0; }
+};
+
+#ifdef HINTSWEEP_SSE2
+// Two words at a time, shifts stay inside each 64-bit lane
+struct Sse2Vector
+{
+    typedef __m128i Type;
+    static const int Width = 2;
+
+    static Type load(const std::uint64_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(std::uint64_t* p, Type a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a); }
+    static Type zero() { return _mm_setzero_si128(); }
+    static Type bitAnd(Type a, Type b) { return _mm_and_si128(a, b); }
+    static Type bitOr(Type a, Type b) { return _mm_or_si128(a, b); }
+    static Type bitXor(Type a, Type b) { return _mm_xor_si128(a, b); }
+    static Type bitAndNot(Type a, Type b) { return _mm_andnot_si128(a, b); }
+    static Type shiftLeft1(Type a) { return _mm_slli_epi64(a, 1); }
+    static Type shiftRight1(Type a) { return _mm_srli_epi64(a, 1); }
+    static Type shiftLeft63(Type a) { return _mm_slli_epi64(a, 63); }
+    static Type shiftRight63(Type a) { return _mm_srli_epi64(a, 63); }
+    static bool isZero(Type a) { return _mm_movemask_epi8(_mm_cmpeq_epi8(a, _mm_setzero_si128())) == 0xffff; }
+};
+#endif
+
+// The words of one 64-cell group, built from the state and number bytes of these cells
+struct PackedWords
+{
+    std::uint64_t revealed = 0;
+    std::uint64_t safe = 0;
+    std::uint64_t unsafe = 0;
+    std::uint64_t number[4] = {};
+};
+
+/*
+ * Packs up to 64 consecutive cells into words, in one pass over the bytes
+ * On SSE2, 16 cells are tested at once and the results are collected with movemask
+ */
+PackedWords packCells(const std::uint8_t* state, const std::uint8_t* numbers, int count)
+{
+    PackedWords words;
+    int i = 0;
+
+#ifdef HINTSWEEP_SSE2
+    const __m128i revealedMask = _mm_set1_epi8(char(Board::Revealed));
+    const __m128i safeMask = _mm_set1_epi8(char(Board::MarkedSafe));
+    const __m128i unsafeMask = _mm_set1_epi8(char(Board::MarkedUnsafe));
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i stateBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + i));
+        __m128i numberBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(numbers + i));
+
+        // Each flag is moved to the top bit of its byte, where movemask reads it
+        // (the 16-bit shifts move bits across byte boundaries, but only the top bit of each byte is read)
+        words.revealed |= std::uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(stateBytes, revealedMask), revealedMask))) << i;
+        words.safe |= std::uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(stateBytes, safeMask), safeMask))) << i;
+        words.unsafe |= std::uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(stateBytes, unsafeMask), unsafeMask))) << i;
+
+        // Numbers are below 16, so bit k reaches the top of the byte after a shift by 7 - k
+        words.number[3] |= std::uint64_t(_mm_movemask_epi8(_mm_slli_epi16(numberBytes, 4))) << i;
+        words.number[2] |= std::uint64_t(_mm_movemask_epi8(_mm_slli_epi16(numberBytes, 5))) << i;
+        words.number[1] |= std::uint64_t(_mm_movemask_epi8(_mm_slli_epi16(numberBytes, 6))) << i;
+        words.number[0] |= std::uint64_t(_mm_movemask_epi8(_mm_slli_epi16(numberBytes, 7))) << i;
+    }
+#endif
+
+    for (; i < count; i++) {
+        std::uint64_t bit = std::uint64_t(1) << i;
+        if (state[i] & Board::Revealed)
+            words.revealed |= bit;
+        if (state[i] & Board::MarkedSafe)
+            words.safe |= bit;
+        if (state[i] & Board::MarkedUnsafe)
+            words.unsafe |= bit;
+        for (int k = 0; k < 4; k++) {
+            if ((numbers[i] >> k) & 1)
+                words.number[k] |= bit;
+        }
+    }
+
+    return words;
+}
+
+} // namespace
+
+bool sweepPlanesScalar(HintSweepPlanes& planes)
+{
+    return sweepPlanes<ScalarVector>(planes);
+}
+
+bool sweepPlanesSse2(HintSweepPlanes& planes)
+{
+#ifdef HINTSWEEP_SSE2
+    return sweepPlanes<Sse2Vector>(planes);
+#else
+    return sweepPlanes<ScalarVector>(planes);
+#endif
+}
+
+// Asks the processor which instruction sets it supports
+HintSweep::InstructionSet HintSweep::bestInstructionSet()
+{
+#if defined(HINTSWEEP_AVX2) && defined(__GNUC__)
+    if (__builtin_cpu_supports("avx2"))
+        return Avx2;
+#elif defined(HINTSWEEP_AVX2) && defined(_MSC_VER)
+    int registers[4];
+    __cpuid(registers, 0);
+    if (registers[0] >= 7) {
+        __cpuidex(registers, 7, 0);
+        bool hasAvx2 = registers[1] & (1 << 5);
+        // The operating system must also save the upper halves of the registers
+        __cpuid(registers, 1);
+        bool hasOsSupport = (registers[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+        if (hasAvx2 && hasOsSupport)
+            return Avx2;
+    }
+#endif
+
+#ifdef HINTSWEEP_SSE2
+    return Sse2;
+#else
+    return Scalar;
+#endif
+}
+
+const char* HintSweep::instructionSetName(InstructionSet instructionSet)
+{
+    switch (instructionSet) {
+    case Avx2:
+        return "avx2";
+    case Sse2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+/*
+ * Allocates the planes for the topology and fills the active plane, which doesn't change during a game
+ * Rows are padded to a multiple of 4 words so that every instruction set walks whole registers
+ */
+HintSweep::HintSweep(const Topology& topology)
+    : m_columnNumber{topology.columnNumber()}
+    , m_rowWords{(topology.columnNumber() + 63) / 64}
+    , m_instructionSet{bestInstructionSet()}
+{
+    m_planes.rowNumber = topology.rowNumber();
+    m_planes.stride = (m_rowWords + 2 + 3) / 4 * 4;
+
+    // One extra register after the last padding row, for the loads one word past the end of a row
+    m_planeSize = std::size_t(m_planes.stride) * (topology.rowNumber() + 2 * HintSweepPlanes::PaddingRows) + 4;
+    m_storage.assign(m_planeSize * HintSweepPlanes::PlaneAmount, 0);
+    setPlanePointers();
+
+    for (int i = 0; i < topology.rowNumber(); i++) {
+        for (int j = 0; j < m_columnNumber; j++) {
+            if (topology.isActive(topology.indexOf(i, j))) {
+                std::size_t word = std::size_t(m_planes.stride) * (i + HintSweepPlanes::PaddingRows) + 1 + j / 64;
+                m_planes.active[word] |= std::uint64_t(1) << (j % 64);
+            }
+        }
+    }
+}
+
+// Copies keep their own planes, the pointers are set again to point into the copied storage
+HintSweep::HintSweep(const HintSweep& other)
+    : m_columnNumber{other.m_columnNumber}
+    , m_rowWords{other.m_rowWords}
+    , m_planeSize{other.m_planeSize}
+    , m_storage{other.m_storage}
+    , m_planes{other.m_planes}
+    , m_loadedSafe{other.m_loadedSafe}
+    , m_loadedUnsafe{other.m_loadedUnsafe}
+    , m_instructionSet{other.m_instructionSet}
+{
+    setPlanePointers();
+}
+
+HintSweep& HintSweep::operator=(const HintSweep& other)
+{
+    if (this != &other) {
+        m_columnNumber = other.m_columnNumber;
+        m_rowWords = other.m_rowWords;
+        m_planeSize = other.m_planeSize;
+        m_storage = other.m_storage;
+        m_planes = other.m_planes;
+        m_loadedSafe = other.m_loadedSafe;
+        m_loadedUnsafe = other.m_loadedUnsafe;
+        m_instructionSet = other.m_instructionSet;
+        setPlanePointers();
+    }
+    return *this;
+}
+
+// The planes are laid out back to back in m_storage, in the order of HintSweepPlanes
+void HintSweep::setPlanePointers()
+{
+    if (m_storage.empty())
+        return;
+
+    std::uint64_t* plane = m_storage.data();
+    std::uint64_t** pointers[HintSweepPlanes::PlaneAmount] = {
+        &m_planes.active, &m_planes.revealed, &m_planes.safe, &m_planes.unsafe, &m_planes.numbered,
+        &m_planes.number[0], &m_planes.number[1], &m_planes.number[2], &m_planes.number[3],
+        &m_planes.counted, &m_planes.centres
+    };
+
+    for (std::uint64_t** pointer : pointers) {
+        *pointer = plane;
+        plane += m_planeSize;
+    }
+}
+
+void HintSweep::setInstructionSet(InstructionSet instructionSet)
+{
+    // Never use an instruction set the processor doesn't have
+    if (instructionSet > bestInstructionSet())
+        instructionSet = bestInstructionSet();
+
+    m_instructionSet = instructionSet;
+}
+
+// Packs the state and number bytes of a Board, row by row, 64 cells per word
+void HintSweep::load(const std::uint8_t* state, const std::uint8_t* numbers)
+{
+    for (int i = 0; i < m_planes.rowNumber; i++) {
+
+        const std::uint8_t* rowState = state + std::size_t(i) * m_columnNumber;
+        const std::uint8_t* rowNumbers = numbers + std::size_t(i) * m_columnNumber;
+        std::size_t word = std::size_t(m_planes.stride) * (i + HintSweepPlanes::PaddingRows) + 1;
+
+        for (int j = 0; j < m_rowWords; j++, word++) {
+
+            int offset = j * 64;
+            int count = (m_columnNumber - offset < 64) ? m_columnNumber - offset : 64;
+
+            PackedWords words = packCells(rowState + offset, rowNumbers + offset, count);
+            m_planes.revealed[word] = words.revealed;
+            m_planes.safe[word] = words.safe;
+            m_planes.unsafe[word] = words.unsafe;
+            m_planes.numbered[word] = words.revealed & (words.number[0] | words.number[1] | words.number[2] | words.number[3]);
+
+            for (int bit = 0; bit < 4; bit++) {
+                m_planes.number[bit][word] = words.number[bit];
+            }
+        }
+    }
+
+    m_loadedSafe.assign(m_planes.safe, m_planes.safe + m_planeSize);
+    m_loadedUnsafe.assign(m_planes.unsafe, m_planes.unsafe + m_planeSize);
+}
+
+bool HintSweep::sweep()
+{
+    switch (m_instructionSet) {
+    case Avx2:
+        return sweepPlanesAvx2(m_planes);
+    case Sse2:
+        return sweepPlanesSse2(m_planes);
+    default:
+        return sweepPlanesScalar(m_planes);
+    }
+}
+
+// Only the words whose marks changed since load() are written back, new marks are usually few
+void HintSweep::store(std::uint8_t* state) const
+{
+    for (int i = 0; i < m_planes.rowNumber; i++) {
+
+        std::uint8_t* rowState = state + std::size_t(i) * m_columnNumber;
+        std::size_t word = std::size_t(m_planes.stride) * (i + HintSweepPlanes::PaddingRows) + 1;
+
+        for (int j = 0; j < m_rowWords; j++, word++) {
+
+            std::uint64_t newSafe = m_planes.safe[word] & ~m_loadedSafe[word];
+            std::uint64_t newUnsafe = m_planes.unsafe[word] & ~m_loadedUnsafe[word];
+
+            // Visit the set bits only, clearing the lowest one each time
+            for (std::uint64_t changed = newSafe | newUnsafe; changed; changed &= changed - 1) {
+                int bit = 0;
+                while (!((changed >> bit) & 1))
+                    bit++;
+
+                if ((newSafe >> bit) & 1)
+                    rowState[j * 64 + bit] |= Board::MarkedSafe;
+                if ((newUnsafe >> bit) & 1)
+                    rowState[j * 64 + bit] |= Board::MarkedUnsafe;
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef HINTSWEEP_H
+#define HINTSWEEP_H
+
+#include <cstdint>
+#include <vector>
+#include "topology.h"
+
+/*
+ * Data-parallel version of the two simple hint rules of Board::markDeductions()
+ *
+ * The board is kept as bitplanes, one bit per cell and one 64-bit word per 64 cells of a row:
+ * active, revealed, marked safe, marked unsafe, "revealed with a number" and the 4 bits of the number
+ * A sweep applies a rule to the whole board at once: the 8 neighbour planes are made by shifting rows,
+ * added with bit-sliced adders into a 4-bit count and compared with the number planes
+ * The word loops run on AVX2 (4 words at a time), SSE2 (2 words) or plain 64-bit words, chosen at runtime
+ *
+ * Edges are handled by zero rows above and below the board and a zero word on both sides of each row,
+ * so boards whose edges wrap around (torus) are not supported and use the neighbour lists of the Topology instead
+ */
+
+// Planes of a board, rows are stride words apart
+// Two zero rows above and below the board keep every neighbour load (one row and one word away) inside the planes
+// Only raw pointers, so that the AVX2 file doesn't instantiate any library template with AVX2 code
+struct HintSweepPlanes
+{
+    static const int PaddingRows = 2;
+    static const int PlaneAmount = 11;
+
+    int rowNumber = 0;
+    int stride = 0;                             // Words per row, including the padding words on both sides
+
+    std::uint64_t* active = nullptr;            // Cell is part of the board
+    std::uint64_t* revealed = nullptr;
+    std::uint64_t* safe = nullptr;              // Marked safe by the hint algorithm
+    std::uint64_t* unsafe = nullptr;            // Marked unsafe by the hint algorithm
+    std::uint64_t* numbered = nullptr;          // Revealed cell with at least one neighbouring mine
+    std::uint64_t* number[4] = {};              // Bits of the number of neighbouring mines
+    std::uint64_t* counted = nullptr;           // Work plane, cells counted by the current rule
+    std::uint64_t* centres = nullptr;           // Work plane, cells where the current rule holds
+};
+
+class HintSweep
+{
+public:
+    enum InstructionSet {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    static bool supports(const Topology& topology) { return !topology.isWrapped(); }
+    static InstructionSet bestInstructionSet();         // Widest instruction set supported by the processor
+    static const char* instructionSetName(InstructionSet instructionSet);
+
+    HintSweep() = default;
+    explicit HintSweep(const Topology& topology);
+    HintSweep(const HintSweep& other);
+    HintSweep& operator=(const HintSweep& other);
+
+    void setInstructionSet(InstructionSet instructionSet);  // Used to compare the implementations, defaults to the best one
+    InstructionSet instructionSet() const { return m_instructionSet; }
+
+    void load(const std::uint8_t* state, const std::uint8_t* numbers); // Builds the planes from the state bytes of a Board
+    bool sweep();                                                      // Applies rule 1 then rule 2 to every cell, returns true if any cell is marked
+    void store(std::uint8_t* state) const;                             // Writes the new marks back to the state bytes
+
+private:
+    int m_columnNumber = 0;
+    int m_rowWords = 0;                                 // Words holding the cells of a row
+    std::size_t m_planeSize = 0;                        // Words of each plane
+    std::vector<std::uint64_t> m_storage;               // Every plane, one after the other
+    HintSweepPlanes m_planes;                           // Points into m_storage
+    std::vector<std::uint64_t> m_loadedSafe;            // Marks at load(), store() only writes the difference
+    std::vector<std::uint64_t> m_loadedUnsafe;
+    InstructionSet m_instructionSet = Scalar;
+
+    void setPlanePointers();
+};
+
+// Implementations for each instruction set, defined in hintsweep.cpp and hintsweep_avx2.cpp
+bool sweepPlanesScalar(HintSweepPlanes& planes);
+bool sweepPlanesSse2(HintSweepPlanes& planes);
+bool sweepPlanesAvx2(HintSweepPlanes& planes);
+
+#endif // HINTSWEEP_H
@@ -0,0 +1,58 @@
+/*
+ * AVX2 version of the word loops of HintSweep, four words at a time
+ * This is the only file compiled for AVX2, HintSweep only calls it after checking that the processor supports it
+ */
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC target("avx2")
+#elif defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#endif
+
+#include "hintsweep.h"
+#include "hintsweep_kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+
+namespace {
+
+struct Avx2Vector
+{
+    typedef __m256i Type;
+    static const int Width = 4;
+
+    static Type load(const std::uint64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(std::uint64_t* p, Type a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a); }
+    static Type zero() { return _mm256_setzero_si256(); }
+    static Type bitAnd(Type a, Type b) { return _mm256_and_si256(a, b); }
+    static Type bitOr(Type a, Type b) { return _mm256_or_si256(a, b); }
+    static Type bitXor(Type a, Type b) { return _mm256_xor_si256(a, b); }
+    static Type bitAndNot(Type a, Type b) { return _mm256_andnot_si256(a, b); }
+    static Type shiftLeft1(Type a) { return _mm256_slli_epi64(a, 1); }
+    static Type shiftRight1(Type a) { return _mm256_srli_epi64(a, 1); }
+    static Type shiftLeft63(Type a) { return _mm256_slli_epi64(a, 63); }
+    static Type shiftRight63(Type a) { return _mm256_srli_epi64(a, 63); }
+    static bool isZero(Type a) { return _mm256_testz_si256(a, a) != 0; }
+};
+
+} // namespace
+
+bool sweepPlanesAvx2(HintSweepPlanes& planes)
+{
+    return sweepPlanes<Avx2Vector>(planes);
+}
+
+#else
+
+// Not an x86 processor, HintSweep never selects AVX2 here
+bool sweepPlanesAvx2(HintSweepPlanes& planes)
+{
+    return sweepPlanesScalar(planes);
+}
+
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#endif
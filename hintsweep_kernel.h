@@ -0,0 +1,145 @@
+#ifndef HINTSWEEP_KERNEL_H
+#define HINTSWEEP_KERNEL_H
+
+#include "hintsweep.h"
+
+/*
+ * Word loops of HintSweep, written once for every instruction set
+ * The Vector parameter provides the register type and the few bitwise operations the sweep needs,
+ * see ScalarVector in hintsweep.cpp for the plain 64-bit version
+ *
+ * Everything here has internal linkage, so the copies compiled for different instruction sets
+ * (hintsweep.cpp and hintsweep_avx2.cpp) never get merged by the linker
+ */
+
+namespace {
+
+// Full adder over every bit of the registers
+template <class Vector>
+inline void addBits(typename Vector::Type a, typename Vector::Type b, typename Vector::Type c,
+                    typename Vector::Type& sum, typename Vector::Type& carry)
+{
+    typename Vector::Type ab = Vector::bitXor(a, b);
+    sum = Vector::bitXor(ab, c);
+    carry = Vector::bitOr(Vector::bitAnd(a, b), Vector::bitAnd(c, ab));
+}
+
+/*
+ * The 8 neighbour planes of the words starting at position
+ * Left and right neighbours shift the row by one bit, the bit crossing a word boundary
+ * comes from the previous (or next) word, which is loaded from one word before (or after)
+ */
+template <class Vector>
+inline void neighbourPlanes(const std::uint64_t* plane, std::size_t position, std::size_t stride, typename Vector::Type neighbours[8])
+{
+    const std::uint64_t* rows[3] = { plane + position - stride, plane + position, plane + position + stride };
+
+    int k = 0;
+    for (int i = 0; i < 3; i++) {
+        typename Vector::Type centre = Vector::load(rows[i]);
+        typename Vector::Type previous = Vector::load(rows[i] - 1);
+        typename Vector::Type next = Vector::load(rows[i] + 1);
+
+        // Bit c of the result holds the cell in column c - 1 (west) or c + 1 (east)
+        neighbours[k++] = Vector::bitOr(Vector::shiftLeft1(centre), Vector::shiftRight63(previous));
+        neighbours[k++] = Vector::bitOr(Vector::shiftRight1(centre), Vector::shiftLeft63(next));
+
+        // The cell itself is not its own neighbour
+        if (i != 1)
+            neighbours[k++] = centre;
+    }
+}
+
+/*
+ * One rule applied to the whole board
+ * Rule 1 (markUnsafe): a numbered cell with as many unrevealed, not-safe neighbours as its number
+ *                      marks its unrevealed, unmarked neighbours as unsafe
+ * Rule 2 (markSafe):   a numbered cell with as many unsafe neighbours as its number
+ *                      marks its unrevealed, unmarked neighbours as safe
+ * Returns true if any cell is marked
+ */
+template <class Vector>
+bool applyRule(HintSweepPlanes& planes, bool markSafe)
+{
+    typedef typename Vector::Type Type;
+
+    const std::size_t stride = std::size_t(planes.stride);
+    const std::size_t first = stride * HintSweepPlanes::PaddingRows;                         // First word of the board
+    const std::size_t last = stride * std::size_t(planes.rowNumber + HintSweepPlanes::PaddingRows); // End of the board
+
+    std::uint64_t* counted = planes.counted;
+    std::uint64_t* centres = planes.centres;
+
+    // Cells counted by the rule, the padding rows of the work planes are never written and stay zero
+    for (std::size_t i = first; i < last; i += Vector::Width) {
+        Type notRevealed = Vector::bitAndNot(Vector::load(&planes.revealed[i]), Vector::load(&planes.active[i]));
+        Type value = markSafe ? Vector::bitAnd(Vector::load(&planes.unsafe[i]), notRevealed)
+                              : Vector::bitAndNot(Vector::load(&planes.safe[i]), notRevealed);
+        Vector::store(&counted[i], value);
+    }
+
+    // Cells where the count equals the number
+    for (std::size_t i = first; i < last; i += Vector::Width) {
+
+        Type n[8];
+        neighbourPlanes<Vector>(counted, i, stride, n);
+
+        // Bit-sliced sum of 8 one-bit planes into bits c0 ... c3
+        Type s1, k1, s2, k2, c0, k3;
+        addBits<Vector>(n[0], n[1], n[2], s1, k1);
+        addBits<Vector>(n[3], n[4], n[5], s2, k2);
+        Type s3 = Vector::bitXor(n[6], n[7]);
+        Type k4 = Vector::bitAnd(n[6], n[7]);
+        addBits<Vector>(s1, s2, s3, c0, k3);
+
+        Type t, f1;
+        addBits<Vector>(k1, k2, k4, t, f1);
+        Type c1 = Vector::bitXor(t, k3);
+        Type f2 = Vector::bitAnd(t, k3);
+        Type c2 = Vector::bitXor(f1, f2);
+        Type c3 = Vector::bitAnd(f1, f2);
+
+        Type difference = Vector::bitOr(Vector::bitOr(Vector::bitXor(c0, Vector::load(&planes.number[0][i])),
+                                                      Vector::bitXor(c1, Vector::load(&planes.number[1][i]))),
+                                        Vector::bitOr(Vector::bitXor(c2, Vector::load(&planes.number[2][i])),
+                                                      Vector::bitXor(c3, Vector::load(&planes.number[3][i]))));
+
+        Vector::store(&centres[i], Vector::bitAndNot(difference, Vector::load(&planes.numbered[i])));
+    }
+
+    // Mark the unrevealed, unmarked neighbours of every cell where the rule holds
+    std::uint64_t* marked = markSafe ? planes.safe : planes.unsafe;
+    Type changes = Vector::zero();
+
+    for (std::size_t i = first; i < last; i += Vector::Width) {
+
+        Type n[8];
+        neighbourPlanes<Vector>(centres, i, stride, n);
+
+        Type nearCentre = Vector::bitOr(Vector::bitOr(Vector::bitOr(n[0], n[1]), Vector::bitOr(n[2], n[3])),
+                                        Vector::bitOr(Vector::bitOr(n[4], n[5]), Vector::bitOr(n[6], n[7])));
+
+        Type unmarked = Vector::bitAndNot(Vector::bitOr(Vector::load(&planes.revealed[i]),
+                                                        Vector::bitOr(Vector::load(&planes.safe[i]), Vector::load(&planes.unsafe[i]))),
+                                          Vector::load(&planes.active[i]));
+
+        Type newMarks = Vector::bitAnd(nearCentre, unmarked);
+        Vector::store(&marked[i], Vector::bitOr(Vector::load(&marked[i]), newMarks));
+        changes = Vector::bitOr(changes, newMarks);
+    }
+
+    return !Vector::isZero(changes);
+}
+
+// Rule 1 over the whole board, then rule 2, like one iteration of the loop in Board::markDeductions()
+template <class Vector>
+bool sweepPlanes(HintSweepPlanes& planes)
+{
+    bool markedUnsafe = applyRule<Vector>(planes, false);
+    bool markedSafe = applyRule<Vector>(planes, true);
+    return markedUnsafe || markedSafe;
+}
+
+} // namespace
+
+#endif // HINTSWEEP_KERNEL_H
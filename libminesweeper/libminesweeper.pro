@@ -0,0 +1,16 @@
+# Shared library exposing the game logic through the C interface in minesweeper_c.h
+
+TEMPLATE = lib
+TARGET = minesweeper
+CONFIG += shared c++17 hide_symbols
+CONFIG -= qt
+
+DEFINES += MINESWEEPER_LIBRARY
+
+include(../engine.pri)
+
+SOURCES += \
+    minesweeper_c.cpp
+
+HEADERS += \
+    minesweeper_c.h
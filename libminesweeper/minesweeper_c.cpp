@@ -0,0 +1,223 @@
+#include "minesweeper_c.h"
+#include "board.h"
+#include <climits>
+#include <memory>
+
+/*
+ * This file implements the C interface declared in minesweeper_c.h on top of the Board class
+ * No exception crosses the interface: a failure (allocation, threads of a giant reveal) is reported as a
+ * NULL board by the create functions and as MS_ERROR by the others
+ */
+
+// The opaque handle handed to C callers
+struct ms_board
+{
+    explicit ms_board(const Topology& topology) : board{topology} {}
+
+    Board board;
+};
+
+namespace {
+
+// Checks the handle and the position, returns the board index or -1
+int indexOf(const ms_board* board, int row, int column)
+{
+    if (!board)
+        return -1;
+
+    const Topology& topology = board->board.topology();
+    if (row < 0 || row >= topology.rowNumber() || column < 0 || column >= topology.columnNumber())
+        return -1;
+
+    return topology.indexOf(row, column);
+}
+
+int statusCode(GameStatus status)
+{
+    switch (status) {
+    case GameStatus::Won:
+        return MS_WON;
+    case GameStatus::Lost:
+        return MS_LOST;
+    default:
+        return MS_PLAYING;
+    }
+}
+
+// Builds the topology requested by the create functions, a NULL mask means every position is a cell
+bool makeTopology(int rows, int columns, const uint8_t* mask, int wrapAround, Topology& topology)
+{
+    // Topology computes the cell amount as int
+    if (rows <= 0 || columns <= 0 || std::int64_t(rows) * columns > INT_MAX)
+        return false;
+
+    if (!mask) {
+        topology = wrapAround ? Topology::torus(rows, columns) : Topology::rectangle(rows, columns);
+        return true;
+    }
+
+    std::vector<bool> cells(std::size_t(rows) * columns);
+    for (std::size_t i = 0; i < cells.size(); i++) {
+        cells[i] = mask[i] != 0;
+    }
+    topology = Topology::masked(rows, columns, cells, wrapAround != 0);
+    return true;
+}
+
+} // namespace
+
+int ms_api_version(void)
+{
+    return MS_API_VERSION;
+}
+
+ms_board* ms_board_create(int rows, int columns, int mines, uint32_t seed, int wrapAround)
+{
+    return ms_board_create_masked(rows, columns, nullptr, mines, seed, wrapAround);
+}
+
+ms_board* ms_board_create_masked(int rows, int columns, const uint8_t* mask, int mines, uint32_t seed, int wrapAround)
+{
+    if (mines < 0)
+        return nullptr;
+
+    try {
+        Topology topology;
+        if (!makeTopology(rows, columns, mask, wrapAround, topology))
+            return nullptr;
+
+        std::unique_ptr<ms_board> board{new ms_board(topology)};
+        board->board.generateMines(mines, seed);
+        board->board.setMineNumbers();
+        return board.release();
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+ms_board* ms_board_create_from_layout(int rows, int columns, const uint8_t* mask, const uint8_t* mines, int wrapAround)
+{
+    if (!mines)
+        return nullptr;
+
+    try {
+        Topology topology;
+        if (!makeTopology(rows, columns, mask, wrapAround, topology))
+            return nullptr;
+
+        std::unique_ptr<ms_board> board{new ms_board(topology)};
+        for (int i = 0; i < topology.cellAmount(); i++) {
+            if (mines[i] && topology.isActive(i))
+                board->board.setMine(i, true);
+        }
+        board->board.setMineNumbers();
+        return board.release();
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void ms_board_destroy(ms_board* board)
+{
+    delete board;
+}
+
+int ms_board_reveal(ms_board* board, int row, int column)
+{
+    int index = indexOf(board, row, column);
+    if (index < 0)
+        return MS_ERROR;
+
+    try {
+        std::vector<int> revealedCells;
+        return statusCode(board->board.reveal(index, revealedCells));
+    }
+    catch (...) {
+        return MS_ERROR;
+    }
+}
+
+int ms_board_flag(ms_board* board, int row, int column)
+{
+    int index = indexOf(board, row, column);
+    if (index < 0)
+        return MS_ERROR;
+
+    board->board.flagCell(index);
+    return statusCode(board->board.status());
+}
+
+// Follows Widget::giveHint(), a cell that is hinted for the second time is revealed
+int ms_board_hint(ms_board* board, int* row, int* column)
+{
+    if (!board)
+        return MS_ERROR;
+
+    int index;
+    try {
+        index = board->board.findHint();
+        if (index < 0)
+            return 0;
+
+        if (board->board.isHinted(index)) {
+            std::vector<int> revealedCells;
+            board->board.reveal(index, revealedCells);
+        }
+    }
+    catch (...) {
+        return MS_ERROR;
+    }
+    board->board.setHinted(index);
+
+    if (row)
+        *row = board->board.topology().rowOf(index);
+    if (column)
+        *column = board->board.topology().columnOf(index);
+    return 1;
+}
+
+void ms_set_hint_cache_bits(int bits)
+{
+    DeductionCache::setSharedCapacityBits(bits);
+}
+
+int ms_board_status(const ms_board* board)
+{
+    return board ? statusCode(board->board.status()) : MS_ERROR;
+}
+
+int ms_board_rows(const ms_board* board)
+{
+    return board ? board->board.topology().rowNumber() : MS_ERROR;
+}
+
+int ms_board_columns(const ms_board* board)
+{
+    return board ? board->board.topology().columnNumber() : MS_ERROR;
+}
+
+int ms_board_mines(const ms_board* board)
+{
+    return board ? board->board.mineAmount() : MS_ERROR;
+}
+
+int ms_board_revealed(const ms_board* board)
+{
+    return board ? board->board.revealedCellAmount() : MS_ERROR;
+}
+
+int ms_board_cell(const ms_board* board, int row, int column)
+{
+    int index = indexOf(board, row, column);
+    if (index < 0)
+        return MS_ERROR;
+
+    return board->board.visibleState()[index];
+}
+
+const uint8_t* ms_board_visible_state(const ms_board* board)
+{
+    return board ? board->board.visibleState() : nullptr;
+}
@@ -0,0 +1,85 @@
+#ifndef MINESWEEPER_C_H
+#define MINESWEEPER_C_H
+
+/*
+ * C interface of the game logic, for bots and other programs that link the rules into their own process
+ * The functions apply exactly the rules used by the game (Board class): reveal with cascade over empty cells,
+ * flagging, win/lose detection and the hint algorithm of the Hint button
+ *
+ * Cells are addressed by row and column, the visible state buffer is in row-major order (row * columns + column)
+ * Functions taking a board return MS_ERROR when the board is NULL, the position is outside the grid,
+ * or the move fails for lack of memory or threads
+ */
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(MINESWEEPER_LIBRARY)
+#    define MS_API __declspec(dllexport)
+#  else
+#    define MS_API __declspec(dllimport)
+#  endif
+#else
+#  define MS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MS_API_VERSION 1        /* Increased whenever a function or a code below changes meaning */
+
+/* Game status, returned by ms_board_status() and the move functions */
+#define MS_PLAYING 0
+#define MS_WON 1
+#define MS_LOST 2
+#define MS_ERROR (-1)
+
+/* Codes of the visible state buffer, 0 ... 8 is a revealed cell showing its number of neighbouring mines */
+#define MS_CELL_HIDDEN 9
+#define MS_CELL_FLAGGED 10
+#define MS_CELL_HINTED 11
+#define MS_CELL_MINE 12
+#define MS_CELL_HOLE 13
+
+typedef struct ms_board ms_board;
+
+MS_API int ms_api_version(void);
+
+/* Creating and destroying boards, the create functions return NULL on invalid arguments (including more than
+ * INT_MAX grid positions) or allocation failure */
+MS_API ms_board* ms_board_create(int rows, int columns, int mines, uint32_t seed, int wrapAround);
+MS_API ms_board* ms_board_create_masked(int rows, int columns, const uint8_t* mask, int mines, uint32_t seed, int wrapAround);
+MS_API ms_board* ms_board_create_from_layout(int rows, int columns, const uint8_t* mask, const uint8_t* mines, int wrapAround);
+MS_API void ms_board_destroy(ms_board* board);
+
+/* Moves, return the game status after the move */
+MS_API int ms_board_reveal(ms_board* board, int row, int column);
+MS_API int ms_board_flag(ms_board* board, int row, int column);
+
+/* Same as the Hint button: suggests a cell that is certainly safe, asking twice for the same cell reveals it
+ * Returns 1 and writes the position if a hint is given, 0 if the known information is not enough */
+MS_API int ms_board_hint(ms_board* board, int* row, int* column);
+
+/* Each thread that asks for hints keeps a cache of 2^bits solved local patterns of 64 bytes each, shared by
+ * all the boards it plays. bits is clamped to 4 ... 24, the default 12 takes 256 KB per thread
+ * A thread whose cache has another size empties and resizes it on its next hint */
+MS_API void ms_set_hint_cache_bits(int bits);
+
+/* Queries */
+MS_API int ms_board_status(const ms_board* board);
+MS_API int ms_board_rows(const ms_board* board);
+MS_API int ms_board_columns(const ms_board* board);
+MS_API int ms_board_mines(const ms_board* board);
+MS_API int ms_board_revealed(const ms_board* board);
+MS_API int ms_board_cell(const ms_board* board, int row, int column);
+
+/* Read-only view of the visible state, rows * columns bytes holding the codes above
+ * The pointer stays valid and is updated in place by every move until the board is destroyed */
+MS_API const uint8_t* ms_board_visible_state(const ms_board* board);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MINESWEEPER_C_H
@@ -1,12 +1,69 @@
 #include "widget.h"
 
 #include <QApplication>
+#include <QFile>
+#include <QTextStream>
 
+/*
+ * The board shape can be chosen on the command line
+ *     --torus          edges of the board wrap around
+ *     --shape <file>   custom shape drawn with '#' (cell) and '.' (hole), one line per row
+ *     --size <rows> <columns> <mines>   rectangle (or torus) of any size, large boards get a zoomable view
+ * and the way large cascades are displayed
+ *     --wave           revealed cells spread out from the clicked cell
+ *     --instant        revealed cells are shown at once, inside the mouse event
+ * and the hint
+ *     --endgame <cells>  largest unknown region searched for the guess most likely to win
+ */
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
     Widget w;
 
+    QStringList arguments = a.arguments();
+    bool wrapAround = arguments.contains("--torus");
+
+    if (arguments.contains("--instant")) {
+        w.setProgressiveReveal(false);
+    }
+    else if (arguments.contains("--wave")) {
+        w.setProgressiveReveal(true, true);
+    }
+
+    int shapeArgument = arguments.indexOf("--shape");
+    if (shapeArgument >= 0 && shapeArgument + 1 < arguments.size()) {
+
+        QFile shapeFile(arguments[shapeArgument + 1]);
+        if (shapeFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+
+            std::vector<std::string> pattern;
+            QTextStream stream(&shapeFile);
+            while (!stream.atEnd()) {
+                pattern.push_back(stream.readLine().toStdString());
+            }
+            w.setTopology(Topology::fromPattern(pattern, wrapAround));
+        }
+    }
+    else if (wrapAround) {
+        w.setTopology(Topology::torus(ROW_NUMBER, COLUMN_NUMBER));
+    }
+
+    int endgameArgument = arguments.indexOf("--endgame");
+    if (endgameArgument >= 0 && endgameArgument + 1 < arguments.size()) {
+        w.setEndgameCells(arguments[endgameArgument + 1].toInt());
+    }
+
+    int sizeArgument = arguments.indexOf("--size");
+    if (sizeArgument >= 0 && sizeArgument + 3 < arguments.size()) {
+
+        int rowNumber = arguments[sizeArgument + 1].toInt();
+        int columnNumber = arguments[sizeArgument + 2].toInt();
+        w.setMineAmount(arguments[sizeArgument + 3].toInt());
+        if (rowNumber > 0 && columnNumber > 0) {
+            w.setTopology(wrapAround ? Topology::torus(rowNumber, columnNumber) : Topology::rectangle(rowNumber, columnNumber));
+        }
+    }
+
 
     w.show();
     return a.exec();
@@ -1,6 +1,6 @@
 QT       += core gui
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets concurrent
 
 CONFIG += c++17
 
@@ -8,15 +8,23 @@ CONFIG += c++17
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+include(engine.pri)
+
 SOURCES += \
+    boardrenderer.cpp \
+    boardview.cpp \
     cell.cpp \
     cellbutton.cpp \
     main.cpp \
+    pngencoder.cpp \
     widget.cpp
 
 HEADERS += \
+    boardrenderer.h \
+    boardview.h \
     cell.h \
     cellbutton.h \
+    pngencoder.h \
     widget.h
 
 # Default rules for deployment.
@@ -0,0 +1,339 @@
+#include "pngencoder.h"
+
+/*
+ * This file provides implementations for the member functions of PngEncoder class declared in pngencoder.h
+ */
+
+namespace {
+
+const std::size_t windowSize = 32768;      // Largest distance of a deflate match
+const std::size_t minimumMatch = 3;
+const std::size_t maximumMatch = 258;
+const int hashBits = 15;
+const int maximumChain = 16;               // Candidates tried for each match, more gives little on sprite rows
+
+const int lengthBases[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                             35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const int lengthExtraBits[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const int distanceBases[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                               257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+const int distanceExtraBits[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                   7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+struct HuffmanCode
+{
+    std::uint16_t bits;         // Bit reversed, deflate writes Huffman codes starting from the most significant bit
+    std::uint8_t length;
+};
+
+std::uint16_t reverseBits(int code, int length)
+{
+    int reversed = 0;
+    for (int i = 0; i < length; i++)
+        reversed |= ((code >> i) & 1) << (length - 1 - i);
+    return std::uint16_t(reversed);
+}
+
+// The fixed Huffman codes of deflate and the tables that find the code of a length or a distance
+struct FixedCodes
+{
+    HuffmanCode literals[288];
+    HuffmanCode distances[30];
+    std::uint8_t lengthCodes[maximumMatch + 1];
+    std::uint8_t distanceCodes[512];        // Distance - 1 below 256, 256 + (distance - 1) / 128 above
+
+    FixedCodes()
+    {
+        for (int i = 0; i < 288; i++) {
+            if (i < 144)
+                literals[i] = {reverseBits(0x30 + i, 8), 8};
+            else if (i < 256)
+                literals[i] = {reverseBits(0x190 + i - 144, 9), 9};
+            else if (i < 280)
+                literals[i] = {reverseBits(i - 256, 7), 7};
+            else
+                literals[i] = {reverseBits(0xc0 + i - 280, 8), 8};
+        }
+
+        for (int i = 0; i < 30; i++)
+            distances[i] = {reverseBits(i, 5), 5};
+
+        for (int i = 0; i < 29; i++) {
+            int end = i == 28 ? 259 : lengthBases[i + 1];
+            for (int length = lengthBases[i]; length < end; length++)
+                lengthCodes[length] = std::uint8_t(i);
+        }
+
+        for (int i = 0; i < 30; i++) {
+            for (int distance = distanceBases[i]; distance < distanceBases[i] + (1 << distanceExtraBits[i]); distance++) {
+                if (distance <= 256)
+                    distanceCodes[distance - 1] = std::uint8_t(i);
+                else
+                    distanceCodes[256 + ((distance - 1) >> 7)] = std::uint8_t(i);
+            }
+        }
+    }
+
+    int distanceCode(std::size_t distance) const
+    {
+        return distance <= 256 ? distanceCodes[distance - 1] : distanceCodes[256 + ((distance - 1) >> 7)];
+    }
+};
+
+const FixedCodes& fixedCodes()
+{
+    static const FixedCodes codes;
+    return codes;
+}
+
+// Deflate packs bits starting from the least significant bit of each byte
+struct BitWriter
+{
+    std::vector<std::uint8_t>& out;
+    std::uint64_t bits = 0;
+    int count = 0;
+
+    void put(std::uint32_t value, int length)
+    {
+        bits |= std::uint64_t(value) << count;
+        count += length;
+        while (count >= 8) {
+            out.push_back(std::uint8_t(bits));
+            bits >>= 8;
+            count -= 8;
+        }
+    }
+
+    void put(const HuffmanCode& code) { put(code.bits, code.length); }
+
+    void alignToByte()
+    {
+        if (count > 0)
+            out.push_back(std::uint8_t(bits));
+        bits = 0;
+        count = 0;
+    }
+};
+
+std::uint32_t adler32(std::uint32_t adler, const std::uint8_t* data, std::size_t size)
+{
+    const std::uint32_t base = 65521;
+    std::uint32_t a = adler & 0xffff;
+    std::uint32_t b = adler >> 16;
+
+    // 5552 bytes is the most that can be summed before b overflows
+    while (size > 0) {
+        std::size_t block = size < 5552 ? size : 5552;
+        size -= block;
+        for (std::size_t i = 0; i < block; i++) {
+            a += data[i];
+            b += a;
+        }
+        data += block;
+        a %= base;
+        b %= base;
+    }
+
+    return a | (b << 16);
+}
+
+// Adler-32 of two pieces joined together, from the checksums of the pieces
+std::uint32_t combineAdler32(std::uint32_t first, std::uint32_t second, std::size_t secondSize)
+{
+    const std::uint32_t base = 65521;
+    std::uint32_t remainder = std::uint32_t(secondSize % base);
+
+    std::uint32_t a = first & 0xffff;
+    std::uint32_t b = std::uint32_t((std::uint64_t(remainder) * a) % base);
+    a += (second & 0xffff) + base - 1;
+    b += ((first >> 16) & 0xffff) + ((second >> 16) & 0xffff) + base - remainder;
+
+    if (a >= base)
+        a -= base;
+    if (a >= base)
+        a -= base;
+    if (b >= base * 2)
+        b -= base * 2;
+    if (b >= base)
+        b -= base;
+
+    return a | (b << 16);
+}
+
+struct CrcTable
+{
+    std::uint32_t entries[256];
+
+    CrcTable()
+    {
+        for (std::uint32_t i = 0; i < 256; i++) {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++)
+                crc = (crc & 1) ? 0xedb88320u ^ (crc >> 1) : crc >> 1;
+            entries[i] = crc;
+        }
+    }
+};
+
+std::uint32_t crc32(std::uint32_t crc, const std::uint8_t* data, std::size_t size)
+{
+    static const CrcTable table;
+
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; i++)
+        crc = table.entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+void appendBigEndian(std::vector<std::uint8_t>& out, std::uint32_t value)
+{
+    for (int i = 3; i >= 0; i--)
+        out.push_back(std::uint8_t(value >> (8 * i)));
+}
+
+// Length, type, data and the CRC of the type and data
+void appendChunk(std::vector<std::uint8_t>& out, const char type[4], const std::uint8_t* data, std::size_t size)
+{
+    appendBigEndian(out, std::uint32_t(size));
+
+    std::size_t typeStart = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + size);
+
+    appendBigEndian(out, crc32(0, out.data() + typeStart, size + 4));
+}
+
+} // namespace
+
+/*
+ * Compresses the rows into one fixed Huffman block, followed by an empty stored block
+ * The empty stored block ends the piece on a byte boundary without ending the deflate stream,
+ * so the next band can start right after it
+ * Matches only look back inside the band, which costs little since a band is many rows high
+ */
+void PngEncoder::compressBand(const std::uint8_t* rows, std::size_t size, PngBand& band)
+{
+    const FixedCodes& codes = fixedCodes();
+
+    band.deflated.clear();
+    band.deflated.reserve(size / 8 + 64);
+    band.size = size;
+    band.adler = adler32(1, rows, size);
+
+    BitWriter writer{band.deflated};
+    writer.put(0, 1);       // Not the last block
+    writer.put(1, 2);       // Fixed Huffman codes
+
+    // Most recent position of each hash, and the position before it with the same hash
+    std::vector<std::int64_t> head(std::size_t(1) << hashBits, -1);
+    std::vector<std::int64_t> previous(windowSize, -1);
+
+    auto hashAt = [rows](std::size_t position) {
+        std::uint32_t bytes = std::uint32_t(rows[position]) | std::uint32_t(rows[position + 1]) << 8 | std::uint32_t(rows[position + 2]) << 16;
+        return (bytes * 2654435761u) >> (32 - hashBits);
+    };
+    auto insert = [&](std::size_t position) {
+        std::uint32_t hash = hashAt(position);
+        previous[position & (windowSize - 1)] = head[hash];
+        head[hash] = std::int64_t(position);
+    };
+
+    std::size_t i = 0;
+    while (i < size) {
+
+        std::size_t bestLength = 0;
+        std::size_t bestDistance = 0;
+
+        if (i + minimumMatch <= size) {
+            std::size_t limit = size - i < maximumMatch ? size - i : maximumMatch;
+            std::int64_t candidate = head[hashAt(i)];
+
+            for (int chain = 0; candidate >= 0 && i - std::size_t(candidate) <= windowSize && chain < maximumChain; chain++) {
+                const std::uint8_t* earlier = rows + candidate;
+                const std::uint8_t* current = rows + i;
+
+                // Only a longer match is of use, so the byte after the best match so far is checked first
+                if (earlier[bestLength] == current[bestLength]) {
+                    std::size_t length = 0;
+                    while (length < limit && earlier[length] == current[length])
+                        length++;
+
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = i - std::size_t(candidate);
+                        if (length == limit)
+                            break;
+                    }
+                }
+
+                candidate = previous[std::size_t(candidate) & (windowSize - 1)];
+            }
+
+            insert(i);
+        }
+
+        if (bestLength >= minimumMatch) {
+            int lengthCode = codes.lengthCodes[bestLength];
+            writer.put(codes.literals[257 + lengthCode]);
+            writer.put(std::uint32_t(bestLength) - std::uint32_t(lengthBases[lengthCode]), lengthExtraBits[lengthCode]);
+
+            int distanceCode = codes.distanceCode(bestDistance);
+            writer.put(codes.distances[distanceCode]);
+            writer.put(std::uint32_t(bestDistance) - std::uint32_t(distanceBases[distanceCode]), distanceExtraBits[distanceCode]);
+
+            // Positions inside the match can still start later matches
+            for (std::size_t j = i + 1; j < i + bestLength && j + minimumMatch <= size; j++)
+                insert(j);
+            i += bestLength;
+        }
+        else {
+            writer.put(codes.literals[rows[i]]);
+            i++;
+        }
+    }
+
+    writer.put(codes.literals[256]);    // End of block
+
+    // Empty stored block: header, padding to the byte boundary, then length 0 and its complement
+    writer.put(0, 3);
+    writer.alignToByte();
+    const std::uint8_t emptyStored[4] = {0x00, 0x00, 0xff, 0xff};
+    band.deflated.insert(band.deflated.end(), emptyStored, emptyStored + 4);
+}
+
+void PngEncoder::begin(int width, int height, std::vector<std::uint8_t>& out)
+{
+    const std::uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    out.insert(out.end(), signature, signature + 8);
+
+    // 8 bits per channel, RGB, no interlacing
+    std::vector<std::uint8_t> header;
+    appendBigEndian(header, std::uint32_t(width));
+    appendBigEndian(header, std::uint32_t(height));
+    const std::uint8_t format[5] = {8, 2, 0, 0, 0};
+    header.insert(header.end(), format, format + 5);
+    appendChunk(out, "IHDR", header.data(), header.size());
+
+    // The zlib header opens the image data, no preset dictionary
+    const std::uint8_t zlibHeader[2] = {0x78, 0x01};
+    appendChunk(out, "IDAT", zlibHeader, 2);
+
+    m_adler = 1;
+}
+
+void PngEncoder::appendBand(const PngBand& band, std::vector<std::uint8_t>& out)
+{
+    appendChunk(out, "IDAT", band.deflated.data(), band.deflated.size());
+    m_adler = combineAdler32(m_adler, band.adler, band.size);
+}
+
+void PngEncoder::finish(std::vector<std::uint8_t>& out)
+{
+    // Last block of the stream, fixed Huffman codes with only the end of block code, then the checksum
+    std::vector<std::uint8_t> end = {0x03, 0x00};
+    appendBigEndian(end, m_adler);
+    appendChunk(out, "IDAT", end.data(), end.size());
+
+    appendChunk(out, "IEND", nullptr, 0);
+}
@@ -0,0 +1,45 @@
+#ifndef PNGENCODER_H
+#define PNGENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Streaming PNG encoder for images too large to hold in memory
+ *
+ * The image is given as bands of whole rows, top to bottom. Each band is compressed on its own,
+ * so bands can be compressed on different threads and written in order as they are done
+ * A compressed band is a byte aligned piece of a deflate stream, and the pieces are simply concatenated
+ * into the zlib stream of the image, the way parallel gzip compressors do it
+ *
+ * Compression uses the fixed Huffman codes of deflate with LZ77 matches, board images are made of
+ * repeated sprites so most of a row is a copy of the row of the cell before it
+ *
+ * The encoder doesn't write anything itself, every call appends the next bytes of the file to out
+ */
+
+// 8-bit RGB rows, each prefixed with the PNG filter byte, see PngEncoder::rowBytes()
+struct PngBand
+{
+    std::vector<std::uint8_t> deflated;     // Compressed rows
+    std::uint32_t adler = 1;                // Adler-32 of the uncompressed rows
+    std::size_t size = 0;                   // Length of the uncompressed rows
+};
+
+class PngEncoder
+{
+public:
+    static std::size_t rowBytes(int width) { return 1 + std::size_t(width) * 3; }   // Filter byte and RGB pixels
+
+    static void compressBand(const std::uint8_t* rows, std::size_t size, PngBand& band);   // Safe to call from several threads
+
+    void begin(int width, int height, std::vector<std::uint8_t>& out);     // Signature and header
+    void appendBand(const PngBand& band, std::vector<std::uint8_t>& out);  // The next band, in top to bottom order
+    void finish(std::vector<std::uint8_t>& out);                           // End of the zlib stream and of the file
+
+private:
+    std::uint32_t m_adler = 1;              // Adler-32 of every band so far
+};
+
+#endif // PNGENCODER_H
@@ -0,0 +1,693 @@
+#include "boardstore.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+/*
+ * This file provides implementations for the board store writer and reader declared in boardstore.h
+ */
+
+#define UNRANK_SMALLEST_RATIO 1e-280      // Ratios of binomial coefficients below it are found again from the numbers
+#define UNRANK_WALK_CELLS 4096            // Longer runs without a ranked cell are searched instead of walked
+
+namespace {
+
+const char headerMagic[4] = {'M', 'S', 'B', 'S'};
+const char footerMagic[4] = {'M', 'S', 'B', 'X'};
+
+void appendU16(std::vector<std::uint8_t>& out, std::uint32_t value)
+{
+    out.push_back(std::uint8_t(value));
+    out.push_back(std::uint8_t(value >> 8));
+}
+
+void appendU32(std::vector<std::uint8_t>& out, std::uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out.push_back(std::uint8_t(value >> (8 * i)));
+}
+
+void appendU64(std::vector<std::uint8_t>& out, std::uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+        out.push_back(std::uint8_t(value >> (8 * i)));
+}
+
+std::uint32_t readU16(const std::uint8_t* data)
+{
+    return std::uint32_t(data[0]) | std::uint32_t(data[1]) << 8;
+}
+
+std::uint32_t readU32(const std::uint8_t* data)
+{
+    return std::uint32_t(data[0]) | std::uint32_t(data[1]) << 8 | std::uint32_t(data[2]) << 16 | std::uint32_t(data[3]) << 24;
+}
+
+std::uint64_t readU64(const std::uint8_t* data)
+{
+    return std::uint64_t(readU32(data)) | std::uint64_t(readU32(data + 4)) << 32;
+}
+
+/*
+ * Unsigned integer of any size, 32-bit words with the least significant first and no leading zero word
+ * Only what ranking needs: products and exact quotients by small factors, sums and differences
+ */
+class BigNumber
+{
+public:
+    explicit BigNumber(std::uint32_t value = 0)
+    {
+        if (value)
+            m_words.push_back(value);
+    }
+
+    bool isZero() const { return m_words.empty(); }
+    const std::vector<std::uint32_t>& words() const { return m_words; }
+
+    void setWords(std::vector<std::uint32_t>& words)
+    {
+        m_words.swap(words);
+        trim();
+    }
+
+    /*
+     * this * factor / divisor, ranking only divides when the quotient is a whole binomial coefficient
+     * An exact quotient needs no division instruction: going up from the least significant word, each word of
+     * the quotient is the word left over times the inverse of the odd part of divisor modulo 2^32, then the
+     * powers of two of divisor are shifted out. Products and quotients are done in the same pass
+     */
+    void multiplyDivide(std::uint32_t factor, std::uint32_t divisor)
+    {
+        int shift = 0;
+        for (; !(divisor & 1); divisor >>= 1) {
+            if (!(factor & 1))
+                factor >>= 1;
+            else
+                shift++;
+        }
+
+        std::uint32_t inverse = divisor;            // Right modulo 2^3 for any odd number
+        for (int i = 0; i < 4; i++)
+            inverse *= 2 - divisor * inverse;       // Each step doubles the right bits
+
+        const std::size_t size = m_words.size();
+        m_words.push_back(0);
+        std::uint64_t carry = 0;
+        std::uint32_t borrow = 0;
+        for (std::size_t i = 0; i <= size; i++) {
+            carry += std::uint64_t(m_words[i]) * factor;
+            std::uint32_t word = std::uint32_t(carry);
+            carry >>= 32;
+
+            std::uint32_t quotient = (word - borrow) * inverse;
+            borrow = std::uint32_t(word < borrow) + std::uint32_t((std::uint64_t(quotient) * divisor) >> 32);
+            m_words[i] = quotient;
+        }
+
+        if (shift) {
+            for (std::size_t i = 0; i < size; i++)
+                m_words[i] = m_words[i] >> shift | m_words[i + 1] << (32 - shift);
+            m_words[size] >>= shift;
+        }
+        trim();
+    }
+
+    void add(const BigNumber& other)
+    {
+        if (m_words.size() < other.m_words.size())
+            m_words.resize(other.m_words.size(), 0);
+
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < m_words.size(); i++) {
+            carry += std::uint64_t(m_words[i]) + (i < other.m_words.size() ? other.m_words[i] : 0);
+            m_words[i] = std::uint32_t(carry);
+            carry >>= 32;
+        }
+        if (carry)
+            m_words.push_back(std::uint32_t(carry));
+    }
+
+    // Only called with other <= this
+    void subtract(const BigNumber& other)
+    {
+        std::int64_t borrow = 0;
+        for (std::size_t i = 0; i < m_words.size(); i++) {
+            if (i >= other.m_words.size() && !borrow)
+                break;
+            std::int64_t difference = std::int64_t(m_words[i]) - (i < other.m_words.size() ? other.m_words[i] : 0) - borrow;
+            borrow = difference < 0 ? 1 : 0;
+            m_words[i] = std::uint32_t(difference + (borrow << 32));
+        }
+        trim();
+    }
+
+    bool isGreaterThan(const BigNumber& other) const
+    {
+        if (m_words.size() != other.m_words.size())
+            return m_words.size() > other.m_words.size();
+
+        for (std::size_t i = m_words.size(); i-- > 0; ) {
+            if (m_words[i] != other.m_words[i])
+                return m_words[i] > other.m_words[i];
+        }
+        return false;
+    }
+
+    int bitLength() const
+    {
+        if (m_words.empty())
+            return 0;
+
+        int bits = int(m_words.size() - 1) * 32;
+        for (std::uint32_t top = m_words.back(); top; top >>= 1)
+            bits++;
+        return bits;
+    }
+
+    // this / other from the three most significant words of each, the relative error is far below 2^-60
+    double ratioTo(const BigNumber& other) const
+    {
+        if (m_words.empty())
+            return 0;
+        if (other.m_words.empty())
+            return HUGE_VAL;
+        return std::ldexp(leadingWords() / other.leadingWords(), 32 * (int(m_words.size()) - int(other.m_words.size())));
+    }
+
+private:
+    std::vector<std::uint32_t> m_words;
+
+    void trim()
+    {
+        while (!m_words.empty() && !m_words.back())
+            m_words.pop_back();
+    }
+
+    // The most significant words as a number below 2^32, of a number that isn't 0
+    double leadingWords() const
+    {
+        double value = 0;
+        double scale = 1;
+        for (std::size_t i = m_words.size(); i-- > 0 && i + 3 >= m_words.size(); scale /= 4294967296.0)
+            value += m_words[i] * scale;
+        return value;
+    }
+};
+
+/*
+ * n choose k, built as C(n - k + 1, 1), C(n - k + 2, 2) ... so every quotient is whole
+ * Consecutive factors are multiplied together while they fit 32 bits, one pass over the words takes several
+ */
+BigNumber binomial(std::uint32_t n, std::uint32_t k)
+{
+    BigNumber value(1);
+    for (std::uint32_t j = 1; j <= k; ) {
+        std::uint64_t numerator = 1;
+        std::uint64_t denominator = 1;
+        while (j <= k && numerator * (n - k + j) <= UINT32_MAX && denominator * j <= UINT32_MAX) {
+            numerator *= n - k + j;
+            denominator *= j;
+            j++;
+        }
+        value.multiplyDivide(std::uint32_t(numerator), std::uint32_t(denominator));
+    }
+    return value;
+}
+
+// Bits of the largest rank of k chosen cells out of n, ceil(log2(n choose k))
+int rankBitsOf(std::uint32_t n, std::uint32_t k)
+{
+    BigNumber largestRank = binomial(n, k);
+    largestRank.subtract(BigNumber(1));
+    return largestRank.bitLength();
+}
+
+/*
+ * Rank of the chosen cells, the sum of C(c, j) over the j-th chosen cell c
+ * A single walk over the cells keeps term = C(c, j + 1), j being the amount of chosen cells before c,
+ * moving to the next cell only multiplies and divides it by small numbers
+ * The factors of a run of cells that are not chosen are packed together while their products fit 32 bits,
+ * a run longer than j + 1 cells builds the term again from j + 1 factors instead
+ */
+BigNumber rankOf(const std::vector<char>& isChosen)
+{
+    BigNumber rank;
+    BigNumber term;             // C(0, 1) = 0
+    std::uint32_t chosen = 0;
+    const std::uint32_t cellAmount = std::uint32_t(isChosen.size());
+
+    for (std::uint32_t c = 0; c < cellAmount; ) {
+        if (isChosen[c]) {
+            rank.add(term);
+            // C(c + 1, j + 2) = C(c, j + 1) * (c + 1) / (j + 2)
+            term.multiplyDivide(c + 1, chosen + 2);
+            chosen++;
+            c++;
+            continue;
+        }
+
+        if (c == chosen) {
+            term = BigNumber(1);                // C(c + 1, c + 1), every cell so far is chosen
+            c++;
+            continue;
+        }
+
+        // C(c + 1, j + 1) = C(c, j + 1) * (c + 1) / (c - j) over the run, or C(end, j + 1) built again if shorter
+        std::uint32_t end = c;
+        while (end < cellAmount && !isChosen[end])
+            end++;
+
+        if (end - c > chosen + 1) {
+            term = binomial(end, chosen + 1);
+            c = end;
+            continue;
+        }
+
+        while (c < end) {
+            std::uint64_t numerator = 1;
+            std::uint64_t denominator = 1;
+            while (c < end && numerator * (c + 1) <= UINT32_MAX && denominator * (c - chosen) <= UINT32_MAX) {
+                numerator *= c + 1;
+                denominator *= c - chosen;
+                c++;
+            }
+            term.multiplyDivide(std::uint32_t(numerator), std::uint32_t(denominator));
+        }
+    }
+
+    return rank;
+}
+
+/*
+ * Inverse of rankOf(): the j-th chosen cell is the largest c with C(c, j) <= rank, for j = k down to 1
+ * The cells are found in decreasing order by a walk down from the last cell, term = C(c, j) is updated by small
+ * products and quotients as c and j decrease. Returns false if rank is not below (n choose k)
+ *
+ * Between two chosen cells the term only decreases, and the cells it certainly stays above the rank for are
+ * passed at once: they are counted in floating point, with a margin far above its error, then the term is
+ * moved past them either by their factors, packed into one pass over the words while their products fit
+ * 32 bits, or built again as C(c, j) from j factors when j is smaller. A sparse layout takes O(mines^2)
+ * passes over the words whatever the board size, a dense one O(cells) over a few words
+ */
+bool unrank(BigNumber rank, std::uint32_t cellAmount, std::uint32_t chosenAmount, std::vector<int>& chosenCells)
+{
+    chosenCells.clear();
+    if (chosenAmount == 0)
+        return rank.isZero();
+
+    std::uint32_t c = cellAmount - 1;
+    BigNumber term = binomial(cellAmount - 1, chosenAmount);
+
+    for (std::uint32_t j = chosenAmount; j >= 1; j--) {
+
+        // C(c - 1, j) = C(c, j) * (c - j) / c, reaches 0 at c = j - 1 at the latest
+        double limit = 0;               // rank / term, divided by the ratio of each move, found again once tiny
+        while (term.isGreaterThan(rank)) {
+            if (limit < UNRANK_SMALLEST_RATIO)
+                limit = rank.ratioTo(term);
+
+            // Cells after which the term is still above the rank, at least the next one is passed
+            // The factors are multiplied into a numerator and a denominator, divided into the ratio every 8 cells,
+            // 8 factors below 2^31 stay far from the largest double
+            std::uint32_t skip = 1;
+            double ratio = double(c - j) / double(c);
+            double numerator = 1;
+            double denominator = 1;
+            const double bound = limit * (1 + 1e-9);
+            while (c - skip > j && skip < UNRANK_WALK_CELLS) {
+                double nextNumerator = numerator * double(c - skip - j);
+                double nextDenominator = denominator * double(c - skip);
+                if (ratio * nextNumerator <= bound * nextDenominator || ratio * nextNumerator < UNRANK_SMALLEST_RATIO * nextDenominator)
+                    break;
+                numerator = nextNumerator;
+                denominator = nextDenominator;
+                skip++;
+                if (skip % 8 == 0) {
+                    ratio *= numerator / denominator;
+                    numerator = 1;
+                    denominator = 1;
+                }
+            }
+            ratio *= numerator / denominator;
+
+            // A longer run is searched by doubling then halving, the log of the ratio after d cells is the sum
+            // of log1p(-d / (c - i)) for i < j, within 1e-13 of the truth for any d
+            if (skip == UNRANK_WALK_CELLS && c - skip > j) {
+                const double logBound = std::log(std::max(limit, UNRANK_SMALLEST_RATIO)) + 1e-9;
+                auto isAbove = [&](std::uint32_t cells) {
+                    double logRatio = 0;
+                    for (std::uint32_t i = 0; i < j; i++)
+                        logRatio += std::log1p(-double(cells) / double(c - i));
+                    return logRatio > logBound;
+                };
+
+                std::uint32_t above = skip;
+                std::uint32_t below = c - j + 1;            // Beyond the last cell that can hold the j-th one
+                for (std::uint32_t probe = 2 * above; probe < below; probe = 2 * above) {
+                    if (!isAbove(probe)) {
+                        below = probe;
+                        break;
+                    }
+                    above = probe;
+                }
+                while (below - above > 1) {
+                    std::uint32_t middle = above + (below - above) / 2;
+                    if (isAbove(middle))
+                        above = middle;
+                    else
+                        below = middle;
+                }
+                skip = above;
+                ratio = 0;                                  // The limit is found again from the numbers
+            }
+
+            if (skip > 1 && j < skip) {
+                term = binomial(c - skip, j);
+            }
+            else {
+                for (std::uint32_t passed = 0; passed < skip; ) {
+                    std::uint64_t numerator = 1;
+                    std::uint64_t denominator = 1;
+                    while (passed < skip && denominator * (c - passed) <= UINT32_MAX) {
+                        numerator *= c - passed - j;
+                        denominator *= c - passed;
+                        passed++;
+                    }
+                    term.multiplyDivide(std::uint32_t(numerator), std::uint32_t(denominator));
+                }
+            }
+
+            c -= skip;
+            limit = ratio > 0 ? limit / ratio : 0;
+        }
+
+        chosenCells.push_back(int(c));
+        rank.subtract(term);
+
+        if (j == 1)
+            break;
+
+        // C(c - 1, j - 1) = C(c, j) * j / c
+        if (c == 0)
+            return false;
+        term.multiplyDivide(j, c);
+        c--;
+    }
+
+    std::reverse(chosenCells.begin(), chosenCells.end());
+    return rank.isZero();
+}
+
+// Reads up to 32 bits starting at any bit, bytes past the end read as zero
+std::uint32_t readBits(const std::uint8_t* data, std::size_t size, std::uint64_t bitOffset, int bitAmount)
+{
+    std::uint64_t value = 0;
+    std::size_t byte = std::size_t(bitOffset / 8);
+    for (int i = 0; i < 5 && byte + std::size_t(i) < size; i++)
+        value |= std::uint64_t(data[byte + std::size_t(i)]) << (8 * i);
+
+    value >>= bitOffset % 8;
+    return std::uint32_t(value & ((std::uint64_t(1) << bitAmount) - 1));
+}
+
+} // namespace
+
+/*
+ * An opening is a region of connected empty cells together with the numbers around it, one click clears it
+ * Every number that isn't next to an empty cell needs a click of its own
+ */
+int boardValue(const Board& board)
+{
+    const Topology& topology = board.topology();
+    std::vector<char> isCleared(std::size_t(topology.cellAmount()), 0);
+    std::vector<int> queue;
+    int value = 0;
+
+    auto isEmptyCell = [&](int index) {
+        return topology.isActive(index) && !board.isMine(index) && board.numberOfNeighbouringMines(index) == 0;
+    };
+
+    for (int i = 0; i < topology.cellAmount(); i++) {
+        if (isCleared[std::size_t(i)] || !isEmptyCell(i))
+            continue;
+
+        value++;
+        isCleared[std::size_t(i)] = 1;
+        queue.assign(1, i);
+        while (!queue.empty()) {
+            int current = queue.back();
+            queue.pop_back();
+            for (const std::uint32_t* n = topology.neighboursBegin(current); n != topology.neighboursEnd(current); ++n) {
+                if (isCleared[*n])
+                    continue;
+                isCleared[*n] = 1;
+                if (isEmptyCell(int(*n)))
+                    queue.push_back(int(*n));
+            }
+        }
+    }
+
+    for (int i = 0; i < topology.cellAmount(); i++) {
+        if (topology.isActive(i) && !board.isMine(i) && !isCleared[std::size_t(i)])
+            value++;
+    }
+
+    return value;
+}
+
+BoardStoreWriter::~BoardStoreWriter()
+{
+    if (m_file)
+        std::fclose(m_file);
+}
+
+bool BoardStoreWriter::open(const std::string& path)
+{
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file)
+        return false;
+
+    std::vector<std::uint8_t> header(headerMagic, headerMagic + 4);
+    appendU32(header, BOARDSTORE_VERSION);
+
+    m_index.clear();
+    m_pendingBytes.clear();
+    m_bitBuffer = 0;
+    m_bufferedBits = 0;
+    m_bitOffset = 0;
+    m_isFailed = std::fwrite(header.data(), 1, header.size(), m_file) != header.size();
+    return !m_isFailed;
+}
+
+void BoardStoreWriter::appendBits(std::uint64_t bits, int bitAmount)
+{
+    // 32 bits at a time, so that the buffer never holds more than 39 bits
+    for (int bit = 0; bit < bitAmount; bit += 32) {
+        int wordBits = std::min(32, bitAmount - bit);
+        m_bitBuffer |= ((bits >> bit) & ((std::uint64_t(1) << wordBits) - 1)) << m_bufferedBits;
+        m_bufferedBits += wordBits;
+        m_bitOffset += std::uint64_t(wordBits);
+
+        while (m_bufferedBits >= 8) {
+            m_pendingBytes.push_back(std::uint8_t(m_bitBuffer));
+            m_bitBuffer >>= 8;
+            m_bufferedBits -= 8;
+        }
+    }
+}
+
+bool BoardStoreWriter::flushBytes()
+{
+    if (!m_pendingBytes.empty() && std::fwrite(m_pendingBytes.data(), 1, m_pendingBytes.size(), m_file) != m_pendingBytes.size())
+        m_isFailed = true;
+    m_pendingBytes.clear();
+    return !m_isFailed;
+}
+
+// The numbers of the board must be set, they give the 3BV
+bool BoardStoreWriter::addBoard(const Board& board)
+{
+    const Topology& topology = board.topology();
+    if (!m_file || m_isFailed || topology.isWrapped() || topology.activeCellAmount() != topology.cellAmount()
+        || topology.rowNumber() >= 65536 || topology.columnNumber() >= 65536)
+        return false;
+
+    const int cellAmount = topology.cellAmount();
+    const int mineAmount = board.mineAmount();
+    const bool isMineChosen = mineAmount <= cellAmount - mineAmount;     // Otherwise the safe cells are ranked
+    const int chosenAmount = isMineChosen ? mineAmount : cellAmount - mineAmount;
+
+    std::vector<char> isChosen(static_cast<std::size_t>(cellAmount));
+    for (int i = 0; i < cellAmount; i++)
+        isChosen[std::size_t(i)] = board.isMine(i) == isMineChosen;
+
+    StoredBoard entry;
+    entry.bitOffset = m_bitOffset;
+    entry.rowNumber = topology.rowNumber();
+    entry.columnNumber = topology.columnNumber();
+    entry.mineAmount = mineAmount;
+    entry.boardValue = boardValue(board);
+    m_index.push_back(entry);
+
+    // Every layout of this size takes the same amount of bits, the leading zero bits of a small rank included
+    if (cellAmount != m_rankBitsCells || chosenAmount != m_rankBitsChosen) {
+        m_rankBits = rankBitsOf(std::uint32_t(cellAmount), std::uint32_t(chosenAmount));
+        m_rankBitsCells = cellAmount;
+        m_rankBitsChosen = chosenAmount;
+    }
+
+    BigNumber rank = rankOf(isChosen);
+    const std::vector<std::uint32_t>& words = rank.words();
+    for (int bit = 0; bit < m_rankBits; bit += 32) {
+        std::size_t word = std::size_t(bit / 32);
+        appendBits(word < words.size() ? words[word] : 0, std::min(32, m_rankBits - bit));
+    }
+
+    return m_pendingBytes.size() < (1 << 16) || flushBytes();
+}
+
+bool BoardStoreWriter::close()
+{
+    if (!m_file)
+        return false;
+
+    if (m_bufferedBits > 0)
+        appendBits(0, 8 - m_bufferedBits);
+    flushBytes();
+
+    std::vector<std::uint8_t> footer;
+    for (const StoredBoard& entry : m_index) {
+        appendU64(footer, entry.bitOffset);
+        appendU16(footer, std::uint32_t(entry.rowNumber));
+        appendU16(footer, std::uint32_t(entry.columnNumber));
+        appendU32(footer, std::uint32_t(entry.mineAmount));
+        appendU32(footer, std::uint32_t(entry.boardValue));
+    }
+    appendU64(footer, BOARDSTORE_HEADER_SIZE + m_bitOffset / 8);
+    appendU32(footer, std::uint32_t(m_index.size()));
+    appendU32(footer, BOARDSTORE_VERSION);
+    footer.insert(footer.end(), footerMagic, footerMagic + 4);
+
+    bool isWritten = !m_isFailed && std::fwrite(footer.data(), 1, footer.size(), m_file) == footer.size();
+    isWritten = std::fclose(m_file) == 0 && isWritten;
+    m_file = nullptr;
+    return isWritten;
+}
+
+bool BoardStoreReader::open(const std::string& path)
+{
+    close();
+
+    if (!m_file.open(path))
+        return false;
+
+    const std::uint8_t* data = m_file.data();
+    const std::size_t size = m_file.size();
+
+    if (size < BOARDSTORE_HEADER_SIZE + BOARDSTORE_FOOTER_SIZE || std::memcmp(data, headerMagic, 4) || readU32(data + 4) != BOARDSTORE_VERSION) {
+        close();
+        return false;
+    }
+
+    const std::uint8_t* footer = data + size - BOARDSTORE_FOOTER_SIZE;
+    std::uint64_t indexOffset = readU64(footer);
+    std::uint32_t boardAmount = readU32(footer + 8);
+
+    if (std::memcmp(footer + 16, footerMagic, 4) || readU32(footer + 12) != BOARDSTORE_VERSION
+        || indexOffset < BOARDSTORE_HEADER_SIZE || indexOffset > size - BOARDSTORE_FOOTER_SIZE
+        || (size - BOARDSTORE_FOOTER_SIZE - indexOffset) != std::uint64_t(boardAmount) * BOARDSTORE_INDEX_ENTRY_SIZE) {
+        close();
+        return false;
+    }
+
+    m_ranks = data + BOARDSTORE_HEADER_SIZE;
+    m_rankBits = (indexOffset - BOARDSTORE_HEADER_SIZE) * 8;
+    m_index = data + indexOffset;
+    m_boardAmount = boardAmount;
+    return true;
+}
+
+void BoardStoreReader::close()
+{
+    m_file.close();
+    m_ranks = nullptr;
+    m_index = nullptr;
+    m_rankBits = 0;
+    m_boardAmount = 0;
+}
+
+StoredBoard BoardStoreReader::board(std::size_t board) const
+{
+    const std::uint8_t* entry = m_index + board * BOARDSTORE_INDEX_ENTRY_SIZE;
+
+    StoredBoard stored;
+    stored.bitOffset = readU64(entry);
+    stored.rowNumber = int(readU16(entry + 8));
+    stored.columnNumber = int(readU16(entry + 10));
+    stored.mineAmount = int(readU32(entry + 12));
+    stored.boardValue = int(readU32(entry + 16));
+    return stored;
+}
+
+// The rank ends where the rank of the next board starts, the last one is padded with zero bits to a whole byte
+bool BoardStoreReader::readMines(std::size_t board, std::vector<int>& mineCells) const
+{
+    mineCells.clear();
+    if (board >= m_boardAmount)
+        return false;
+
+    const StoredBoard stored = this->board(board);
+    const std::uint64_t rankEnd = board + 1 < m_boardAmount ? this->board(board + 1).bitOffset : m_rankBits;
+    const std::int64_t cellAmount = std::int64_t(stored.rowNumber) * stored.columnNumber;
+    if (cellAmount > INT_MAX || stored.mineAmount > cellAmount || rankEnd < stored.bitOffset || rankEnd > m_rankBits
+        || rankEnd - stored.bitOffset > std::uint64_t(cellAmount) + 8)
+        return false;
+
+    const std::size_t rankBytes = std::size_t(m_rankBits / 8);
+    const int rankBits = int(rankEnd - stored.bitOffset);
+    std::vector<std::uint32_t> words;
+    for (int bit = 0; bit < rankBits; bit += 32)
+        words.push_back(readBits(m_ranks, rankBytes, stored.bitOffset + std::uint64_t(bit), std::min(32, rankBits - bit)));
+
+    BigNumber rank;
+    rank.setWords(words);
+
+    const bool isMineChosen = stored.mineAmount <= cellAmount - stored.mineAmount;
+    if (isMineChosen)
+        return unrank(rank, std::uint32_t(cellAmount), std::uint32_t(stored.mineAmount), mineCells);
+
+    // The safe cells were ranked, the mines are the other cells
+    std::vector<int> safeCells;
+    if (!unrank(rank, std::uint32_t(cellAmount), std::uint32_t(cellAmount - stored.mineAmount), safeCells))
+        return false;
+
+    std::size_t next = 0;
+    for (int i = 0; i < int(cellAmount); i++) {
+        if (next < safeCells.size() && safeCells[next] == i)
+            next++;
+        else
+            mineCells.push_back(i);
+    }
+    return true;
+}
+
+bool BoardStoreReader::readBoard(std::size_t board, Board& layout) const
+{
+    std::vector<int> mineCells;
+    if (board >= m_boardAmount)
+        return false;
+
+    const StoredBoard stored = this->board(board);
+    const Topology& topology = layout.topology();
+
+    if (topology.rowNumber() != stored.rowNumber || topology.columnNumber() != stored.columnNumber || !readMines(board, mineCells))
+        return false;
+
+    for (int i = 0; i < topology.cellAmount(); i++)
+        layout.setMine(i, false);
+    for (int cell : mineCells)
+        layout.setMine(cell, true);
+    layout.setMineNumbers();
+    return true;
+}
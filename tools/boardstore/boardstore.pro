@@ -0,0 +1,20 @@
+# Stores fixed mine layouts compactly and reads any of them back without reading the whole file
+
+TEMPLATE = app
+TARGET = boardstore
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+# The memory mapping of the dataset tool
+INCLUDEPATH += ../dataset
+
+SOURCES += \
+    ../dataset/mappedfile.cpp \
+    boardstore.cpp \
+    main.cpp
+
+HEADERS += \
+    ../dataset/mappedfile.h \
+    boardstore.h
@@ -0,0 +1,194 @@
+#include "boardstore.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <random>
+
+/*
+ * Writes a board store of random layouts, and reads boards back from one
+ *
+ * write: board i is generated with seed + i, like the games of the other tools, so a store can be checked
+ *        against the layouts it was made from, fails if the layouts take more than a bit over log2(n choose k)
+ * read:  decodes boards in random order through the memory mapping and reports the decoding time,
+ *        with --seed every decoded layout and its 3BV are compared with a freshly generated one
+ *
+ * Usage: boardstore write FILE [--boards N] [--rows R] [--columns C] [--mines M] [--seed S]
+ *        boardstore read FILE [--seed S] [--samples N]
+ */
+
+namespace {
+
+struct Options
+{
+    bool isWrite = true;
+    std::string path;
+    int boards = 100000;
+    int rows = 16;
+    int columns = 30;
+    int mines = 99;
+    std::uint32_t seed = 1;
+    bool isChecked = false;         // --seed given to read
+    int samples = 0;                // Boards decoded by read, 0 decodes every board
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    if (argc < 3)
+        return false;
+
+    if (!std::strcmp(argv[1], "read"))
+        options.isWrite = false;
+    else if (std::strcmp(argv[1], "write"))
+        return false;
+    options.path = argv[2];
+
+    for (int i = 3; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--boards") && hasValue)
+            options.boards = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--rows") && hasValue)
+            options.rows = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--columns") && hasValue)
+            options.columns = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--mines") && hasValue)
+            options.mines = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seed") && hasValue) {
+            options.seed = std::uint32_t(std::strtoul(argv[++i], nullptr, 10));
+            options.isChecked = true;
+        }
+        else if (!std::strcmp(argv[i], "--samples") && hasValue)
+            options.samples = std::atoi(argv[++i]);
+        else
+            return false;
+    }
+
+    if (options.rows <= 0 || options.columns <= 0 || options.rows >= 65536 || options.columns >= 65536)
+        return false;
+
+    const std::int64_t cellAmount = std::int64_t(options.rows) * options.columns;
+    return cellAmount <= INT_MAX && options.mines >= 0 && options.mines <= cellAmount;
+}
+
+int writeStore(const Options& options)
+{
+    BoardStoreWriter writer;
+    if (!writer.open(options.path)) {
+        std::fprintf(stderr, "can't open %s\n", options.path.c_str());
+        return 1;
+    }
+
+    Topology topology = Topology::rectangle(options.rows, options.columns);
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < options.boards; i++) {
+        Board board(topology);
+        board.generateMines(options.mines, options.seed + std::uint32_t(i));
+        board.setMineNumbers();
+        if (!writer.addBoard(board))
+            break;
+    }
+
+    // the last rank is padded to a byte on close, which is not part of any layout
+    std::uint64_t rankBits = writer.rankBits();
+    if (!writer.close() || writer.boardAmount() != std::size_t(options.boards)) {
+        std::fprintf(stderr, "can't write %s\n", options.path.c_str());
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    int cellAmount = topology.cellAmount();
+    double layoutBits = double(rankBits) / options.boards;
+    double fileSize = BOARDSTORE_HEADER_SIZE + double((rankBits + 7) / 8)
+                      + double(options.boards) * BOARDSTORE_INDEX_ENTRY_SIZE + BOARDSTORE_FOOTER_SIZE;
+
+    // log2(n choose k), the information in one layout
+    double entropy = (std::lgamma(cellAmount + 1.0) - std::lgamma(options.mines + 1.0) - std::lgamma(cellAmount - options.mines + 1.0)) / std::log(2.0);
+
+    std::printf("boards      %d (%dx%d, %d mines)\n", options.boards, options.rows, options.columns, options.mines);
+    std::printf("layout      %.1f bits on average (log2 of the layout amount %.2f, one bit per cell %d)\n", layoutBits, entropy, cellAmount);
+    std::printf("file size   %.2f MB (%.1f bytes per board with the index entry)\n", fileSize / 1e6, fileSize / options.boards);
+    std::printf("time        %.3f s (%.0f boards per second)\n", seconds, seconds > 0 ? options.boards / seconds : 0.0);
+
+    // A rank is written with ceil(log2(n choose k)) bits, the margin covers the rounding of lgamma
+    if (layoutBits > entropy + 1 + 1e-6) {
+        std::fprintf(stderr, "layouts take %.2f bits over log2 of the layout amount\n", layoutBits - entropy);
+        return 1;
+    }
+    return 0;
+}
+
+int readStore(const Options& options)
+{
+    BoardStoreReader reader;
+    if (!reader.open(options.path)) {
+        std::fprintf(stderr, "%s is not a board store\n", options.path.c_str());
+        return 1;
+    }
+
+    // Random order, each board is found through the index alone
+    std::vector<std::size_t> order(reader.boardAmount());
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::shuffle(order.begin(), order.end(), std::mt19937{12345});
+    if (options.samples > 0 && std::size_t(options.samples) < order.size())
+        order.resize(std::size_t(options.samples));
+
+    std::vector<int> mineCells;
+    std::size_t corrupt = 0;
+    std::size_t wrong = 0;
+    double decodeSeconds = 0;
+    long long mineTotal = 0;
+
+    for (std::size_t i : order) {
+        auto start = std::chrono::steady_clock::now();
+        bool isRead = reader.readMines(i, mineCells);
+        decodeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        StoredBoard stored = reader.board(i);
+        if (!isRead || int(mineCells.size()) != stored.mineAmount) {
+            corrupt++;
+            continue;
+        }
+        mineTotal += stored.mineAmount;
+
+        if (!options.isChecked)
+            continue;
+
+        Board expected(Topology::rectangle(stored.rowNumber, stored.columnNumber));
+        expected.generateMines(stored.mineAmount, options.seed + std::uint32_t(i));
+        expected.setMineNumbers();
+
+        bool isSame = boardValue(expected) == stored.boardValue;
+        for (int cell : mineCells)
+            isSame = isSame && expected.isMine(cell);
+        if (!isSame)
+            wrong++;
+    }
+
+    std::printf("boards      %zu in %.2f MB\n", reader.boardAmount(), reader.fileSize() / 1e6);
+    std::printf("decoded     %zu boards, %.2f us per board (%.1f ns per mine)\n", order.size(),
+                order.empty() ? 0.0 : decodeSeconds * 1e6 / order.size(), mineTotal ? decodeSeconds * 1e9 / mineTotal : 0.0);
+    std::printf("corrupt     %zu\n", corrupt);
+    if (options.isChecked)
+        std::printf("wrong       %zu\n", wrong);
+
+    return corrupt || wrong ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: boardstore write FILE [--boards N] [--rows R] [--columns C] [--mines M] [--seed S]\n"
+                             "       boardstore read FILE [--seed S] [--samples N]\n");
+        return 2;
+    }
+
+    return options.isWrite ? writeStore(options) : readStore(options);
+}
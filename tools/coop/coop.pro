@@ -0,0 +1,11 @@
+# Plays one shared board from several threads and checks the result against the sequential Board
+
+TEMPLATE = app
+TARGET = coop
+CONFIG += console c++17 thread
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    main.cpp
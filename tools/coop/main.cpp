@@ -0,0 +1,132 @@
+#include "concurrentboard.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+
+/*
+ * Bots reveal random safe cells of one shared ConcurrentBoard, each bot on its own thread
+ * Reports the reveal throughput and checks that
+ *   every cell was revealed by exactly one bot,
+ *   the atomic counter agrees with the cells,
+ *   the revealed cells are the same as a Board gets from the same clicks, one after the other
+ *
+ * Usage: coop [--threads T] [--rows R] [--columns C] [--mines M] [--clicks N] [--seed S]
+ */
+
+namespace {
+
+struct Options
+{
+    int threads = 4;
+    int rows = 1000;
+    int columns = 1000;
+    int mines = 150000;
+    int clicks = 20000;             // Clicks of each bot
+    std::uint32_t seed = 1;
+};
+
+Options parseOptions(int argc, char* argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--threads") && hasValue)
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--rows") && hasValue)
+            options.rows = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--columns") && hasValue)
+            options.columns = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--mines") && hasValue)
+            options.mines = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--clicks") && hasValue)
+            options.clicks = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seed") && hasValue)
+            options.seed = std::uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options = parseOptions(argc, argv);
+    Topology topology = Topology::rectangle(options.rows, options.columns);
+
+    Board layout(topology);
+    layout.generateMines(options.mines, options.seed);
+    layout.setMineNumbers();
+
+    ConcurrentBoard board(layout);
+
+    // Bots only click safe cells, so the game goes on and the reveal path is what gets measured
+    std::vector<std::vector<int>> clicks(std::size_t(options.threads));
+    std::vector<std::vector<int>> revealed(std::size_t(options.threads));
+    std::uniform_int_distribution<> randomCell{0, topology.cellAmount() - 1};
+    for (int t = 0; t < options.threads; t++) {
+        std::mt19937 mt{options.seed + std::uint32_t(t) + 1};
+        while (int(clicks[std::size_t(t)].size()) < options.clicks) {
+            int index = randomCell(mt);
+            if (!layout.isMine(index))
+                clicks[std::size_t(t)].push_back(index);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < options.threads; t++) {
+        threads.emplace_back([&, t]() {
+            for (int index : clicks[std::size_t(t)])
+                board.reveal(index, t, revealed[std::size_t(t)]);
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Every cell once, by the bot the cell itself names
+    std::vector<int> revealCount(std::size_t(topology.cellAmount()), 0);
+    bool isConsistent = true;
+    long long revealedTotal = 0;
+    for (int t = 0; t < options.threads; t++) {
+        for (int index : revealed[std::size_t(t)]) {
+            revealCount[std::size_t(index)]++;
+            isConsistent = isConsistent && board.revealedBy(index) == t;
+        }
+        revealedTotal += (long long)revealed[std::size_t(t)].size();
+    }
+
+    int revealedCells = 0;
+    for (int i = 0; i < topology.cellAmount(); i++) {
+        isConsistent = isConsistent && revealCount[std::size_t(i)] == (board.isRevealed(i) ? 1 : 0);
+        revealedCells += board.isRevealed(i) ? 1 : 0;
+    }
+    isConsistent = isConsistent && revealedCells == board.revealedCellAmount() && revealedTotal == revealedCells;
+
+    // A reveal always opens the same cells whoever gets there first, so any sequential order must agree
+    Board sequential = layout;
+    std::vector<int> sequentialRevealed;
+    for (int t = 0; t < options.threads; t++) {
+        for (int index : clicks[std::size_t(t)])
+            sequential.reveal(index, sequentialRevealed);
+    }
+    bool isSameAsBoard = sequential.status() == board.status();
+    for (int i = 0; i < topology.cellAmount(); i++)
+        isSameAsBoard = isSameAsBoard && sequential.isRevealed(i) == board.isRevealed(i);
+
+    std::printf("board       %dx%d, %d mines\n", options.rows, options.columns, options.mines);
+    std::printf("clicks      %d on each of %d threads\n", options.clicks, options.threads);
+    std::printf("revealed    %d cells (%s)\n", revealedCells,
+                board.status() == GameStatus::Won ? "won" : board.status() == GameStatus::Lost ? "lost" : "playing");
+    std::printf("time        %.3f ms (%.1f million cells per second)\n", seconds * 1e3, seconds > 0 ? revealedCells / seconds / 1e6 : 0.0);
+    std::printf("each once   %s\n", isConsistent ? "yes" : "NO");
+    std::printf("as Board    %s\n", isSameAsBoard ? "yes" : "NO");
+
+    return isConsistent && isSameAsBoard ? 0 : 1;
+}
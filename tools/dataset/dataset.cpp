@@ -0,0 +1,513 @@
+#include "dataset.h"
+#include <climits>
+#include <cstring>
+
+/*
+ * This file provides implementations for the dataset chunk builder, writer and reader declared in dataset.h
+ */
+
+namespace {
+
+const char headerMagic[4] = {'M', 'S', 'D', 'S'};
+const char footerMagic[4] = {'M', 'S', 'D', 'X'};
+
+const int chunkHeaderSize = 24;         // Game amount, position amount and the sizes of the 4 columns
+const int gameEntrySize = 16;           // Id, rows, columns, mine amount, position amount
+const int indexEntrySize = 20;          // Offset, size, position amount, game amount
+
+// A run of at least this many zero bytes ends a literal run of the zero-run encoding
+const int minimumZeroRun = 3;
+
+void appendU16(std::vector<std::uint8_t>& out, std::uint32_t value)
+{
+    out.push_back(std::uint8_t(value));
+    out.push_back(std::uint8_t(value >> 8));
+}
+
+void appendU32(std::vector<std::uint8_t>& out, std::uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out.push_back(std::uint8_t(value >> (8 * i)));
+}
+
+void appendU64(std::vector<std::uint8_t>& out, std::uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+        out.push_back(std::uint8_t(value >> (8 * i)));
+}
+
+std::uint32_t readU16(const std::uint8_t* data)
+{
+    return std::uint32_t(data[0]) | std::uint32_t(data[1]) << 8;
+}
+
+std::uint32_t readU32(const std::uint8_t* data)
+{
+    return std::uint32_t(data[0]) | std::uint32_t(data[1]) << 8 | std::uint32_t(data[2]) << 16 | std::uint32_t(data[3]) << 24;
+}
+
+std::uint64_t readU64(const std::uint8_t* data)
+{
+    return std::uint64_t(readU32(data)) | std::uint64_t(readU32(data + 4)) << 32;
+}
+
+void appendVarint(std::vector<std::uint8_t>& out, std::size_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(std::uint8_t(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(std::uint8_t(value));
+}
+
+// Returns false if the varint runs past end
+bool readVarint(const std::uint8_t*& data, const std::uint8_t* end, std::size_t& value)
+{
+    value = 0;
+    for (int shift = 0; data < end && shift < 64; shift += 7) {
+        std::uint8_t byte = *data++;
+        value |= std::size_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+/*
+ * Zero-run encoding: a sequence of (zero byte amount, literal byte amount, literal bytes), both amounts as varints
+ * The XOR of two positions is mostly zero bytes, so this removes most of the column
+ */
+void encodeZeroRuns(const std::vector<std::uint8_t>& input, std::vector<std::uint8_t>& out)
+{
+    const std::size_t size = input.size();
+    std::size_t i = 0;
+
+    while (i < size) {
+        std::size_t zeroStart = i;
+        while (i < size && input[i] == 0)
+            i++;
+        std::size_t zeroAmount = i - zeroStart;
+
+        // The literal run goes on until a long enough run of zero bytes
+        std::size_t literalStart = i;
+        while (i < size) {
+            if (input[i] == 0) {
+                std::size_t j = i;
+                while (j < size && input[j] == 0 && j - i < minimumZeroRun)
+                    j++;
+                if (j - i == minimumZeroRun || j == size)
+                    break;
+                i = j;
+            }
+            else {
+                i++;
+            }
+        }
+
+        appendVarint(out, zeroAmount);
+        appendVarint(out, i - literalStart);
+        out.insert(out.end(), input.begin() + std::ptrdiff_t(literalStart), input.begin() + std::ptrdiff_t(i));
+    }
+}
+
+// Returns false if the encoded data is malformed or doesn't decode to exactly size bytes
+bool decodeZeroRuns(const std::uint8_t* data, std::size_t encodedSize, std::size_t size, std::vector<std::uint8_t>& out)
+{
+    out.resize(size);
+    const std::uint8_t* end = data + encodedSize;
+    std::size_t position = 0;
+
+    while (data < end) {
+        std::size_t zeroAmount, literalAmount;
+        if (!readVarint(data, end, zeroAmount) || !readVarint(data, end, literalAmount))
+            return false;
+        if (zeroAmount > size - position || literalAmount > size - position - zeroAmount || literalAmount > std::size_t(end - data))
+            return false;
+
+        std::memset(out.data() + position, 0, zeroAmount);
+        position += zeroAmount;
+        std::memcpy(out.data() + position, data, literalAmount);
+        position += literalAmount;
+        data += literalAmount;
+    }
+
+    return position == size;
+}
+
+std::size_t visibleBytes(std::size_t cellAmount) { return (cellAmount + 1) / 2; }
+std::size_t labelBytes(std::size_t cellAmount) { return (cellAmount + 3) / 4; }
+std::size_t mineBytes(std::size_t cellAmount) { return (cellAmount + 7) / 8; }
+
+// Cells of every packed byte, so that unpacking is a copy per byte instead of a shift per cell
+struct UnpackTables
+{
+    std::uint8_t visible[256][2];
+    std::uint8_t labels[256][4];
+    std::uint8_t mines[256][8];
+
+    UnpackTables()
+    {
+        for (int byte = 0; byte < 256; byte++) {
+            for (int i = 0; i < 2; i++)
+                visible[byte][i] = std::uint8_t((byte >> (4 * i)) & 0xf);
+            for (int i = 0; i < 4; i++)
+                labels[byte][i] = std::uint8_t((byte >> (2 * i)) & 0x3);
+            for (int i = 0; i < 8; i++)
+                mines[byte][i] = std::uint8_t((byte >> i) & 1);
+        }
+    }
+};
+
+const UnpackTables& unpackTables()
+{
+    static const UnpackTables tables;
+    return tables;
+}
+
+// Unpacks cellAmount cells of cellsPerByte cells each, the last byte may hold fewer cells
+template <int cellsPerByte>
+void unpackCells(const std::uint8_t* packed, const std::uint8_t (*table)[cellsPerByte], int cellAmount, std::uint8_t* cells)
+{
+    int wholeBytes = cellAmount / cellsPerByte;
+    for (int i = 0; i < wholeBytes; i++)
+        std::memcpy(cells + i * cellsPerByte, table[packed[i]], cellsPerByte);
+
+    int rest = cellAmount - wholeBytes * cellsPerByte;
+    if (rest)
+        std::memcpy(cells + wholeBytes * cellsPerByte, table[packed[wholeBytes]], std::size_t(rest));
+}
+
+} // namespace
+
+void DatasetChunk::clear()
+{
+    games.clear();
+    mines.clear();
+    positionGames.clear();
+    cellOffsets.clear();
+    visible.clear();
+    labels.clear();
+}
+
+// The previous position of a new game is all zeros, so its first position is stored as is
+void DatasetChunkBuilder::beginGame(std::uint32_t id, const Board& board)
+{
+    const Topology& topology = board.topology();
+    const int cellAmount = topology.cellAmount();
+
+    m_games.push_back({id, topology.rowNumber(), topology.columnNumber(), board.mineAmount(), 0});
+
+    std::size_t offset = m_mines.size();
+    m_mines.resize(offset + mineBytes(cellAmount), 0);
+    for (int i = 0; i < cellAmount; i++) {
+        if (board.isMine(i))
+            m_mines[offset + std::size_t(i / 8)] |= std::uint8_t(1 << (i % 8));
+    }
+
+    m_previousVisible.assign(visibleBytes(cellAmount), 0);
+    m_previousLabels.assign(labelBytes(cellAmount), 0);
+}
+
+void DatasetChunkBuilder::addPosition(const Board& board)
+{
+    const int cellAmount = board.topology().cellAmount();
+    const std::uint8_t* visible = board.visibleState();
+
+    m_packed.assign(visibleBytes(cellAmount), 0);
+    for (int i = 0; i < cellAmount; i++)
+        m_packed[std::size_t(i / 2)] |= std::uint8_t(visible[i] << (4 * (i % 2)));
+
+    for (std::size_t i = 0; i < m_packed.size(); i++) {
+        m_visibleDeltas.push_back(m_packed[i] ^ m_previousVisible[i]);
+        m_previousVisible[i] = m_packed[i];
+    }
+
+    // Marks are only meaningful on cells the player hasn't revealed yet
+    m_packed.assign(labelBytes(cellAmount), 0);
+    for (int i = 0; i < cellAmount; i++) {
+        if (!board.topology().isActive(i) || board.isRevealed(i))
+            continue;
+
+        std::uint8_t label = board.isMarkedUnsafe(i) ? LabelMine : board.isMarkedSafe(i) ? LabelSafe : LabelUnknown;
+        m_packed[std::size_t(i / 4)] |= std::uint8_t(label << (2 * (i % 4)));
+    }
+
+    for (std::size_t i = 0; i < m_packed.size(); i++) {
+        m_labelDeltas.push_back(m_packed[i] ^ m_previousLabels[i]);
+        m_previousLabels[i] = m_packed[i];
+    }
+
+    m_games.back().positionAmount++;
+    m_positionAmount++;
+}
+
+void DatasetChunkBuilder::encode(std::vector<std::uint8_t>& chunk) const
+{
+    chunk.clear();
+    chunk.resize(chunkHeaderSize);
+
+    std::size_t columnStart = chunk.size();
+    for (const Game& game : m_games) {
+        appendU32(chunk, game.id);
+        appendU16(chunk, std::uint32_t(game.rowNumber));
+        appendU16(chunk, std::uint32_t(game.columnNumber));
+        appendU32(chunk, std::uint32_t(game.mineAmount));
+        appendU32(chunk, std::uint32_t(game.positionAmount));
+    }
+    std::uint32_t gamesSize = std::uint32_t(chunk.size() - columnStart);
+
+    // Mine layouts are random, there is nothing to gain from encoding them
+    chunk.insert(chunk.end(), m_mines.begin(), m_mines.end());
+    std::uint32_t minesSize = std::uint32_t(m_mines.size());
+
+    columnStart = chunk.size();
+    encodeZeroRuns(m_visibleDeltas, chunk);
+    std::uint32_t visibleSize = std::uint32_t(chunk.size() - columnStart);
+
+    columnStart = chunk.size();
+    encodeZeroRuns(m_labelDeltas, chunk);
+    std::uint32_t labelsSize = std::uint32_t(chunk.size() - columnStart);
+
+    std::vector<std::uint8_t> header;
+    appendU32(header, std::uint32_t(m_games.size()));
+    appendU32(header, std::uint32_t(m_positionAmount));
+    appendU32(header, gamesSize);
+    appendU32(header, minesSize);
+    appendU32(header, visibleSize);
+    appendU32(header, labelsSize);
+    std::memcpy(chunk.data(), header.data(), chunkHeaderSize);
+}
+
+void DatasetChunkBuilder::clear()
+{
+    m_games.clear();
+    m_mines.clear();
+    m_visibleDeltas.clear();
+    m_labelDeltas.clear();
+    m_positionAmount = 0;
+}
+
+DatasetWriter::~DatasetWriter()
+{
+    if (m_file)
+        std::fclose(m_file);
+}
+
+bool DatasetWriter::open(const std::string& path)
+{
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file)
+        return false;
+
+    // Chunks are large, a bigger buffer saves system calls between them
+    std::setvbuf(m_file, nullptr, _IOFBF, 1 << 20);
+
+    std::vector<std::uint8_t> header(headerMagic, headerMagic + 4);
+    appendU32(header, DATASET_VERSION);
+
+    m_offset = header.size();
+    m_index.clear();
+    m_isFailed = std::fwrite(header.data(), 1, header.size(), m_file) != header.size();
+    return !m_isFailed;
+}
+
+bool DatasetWriter::writeChunk(std::uint32_t chunkNumber, const std::vector<std::uint8_t>& chunk)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_file || m_isFailed || chunk.size() < std::size_t(chunkHeaderSize) || m_index.count(chunkNumber))
+        return false;
+
+    if (std::fwrite(chunk.data(), 1, chunk.size(), m_file) != chunk.size()) {
+        m_isFailed = true;
+        return false;
+    }
+
+    m_index[chunkNumber] = {m_offset, std::uint32_t(chunk.size()), readU32(chunk.data() + 4), readU32(chunk.data())};
+    m_offset += chunk.size();
+    return true;
+}
+
+bool DatasetWriter::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_file)
+        return false;
+
+    std::vector<std::uint8_t> footer;
+    for (const auto& entry : m_index) {
+        appendU64(footer, entry.second.offset);
+        appendU32(footer, entry.second.size);
+        appendU32(footer, entry.second.positionAmount);
+        appendU32(footer, entry.second.gameAmount);
+    }
+    appendU64(footer, m_offset);
+    appendU32(footer, std::uint32_t(m_index.size()));
+    appendU32(footer, DATASET_VERSION);
+    footer.insert(footer.end(), footerMagic, footerMagic + 4);
+
+    bool isWritten = !m_isFailed && std::fwrite(footer.data(), 1, footer.size(), m_file) == footer.size();
+    isWritten = std::fclose(m_file) == 0 && isWritten;
+    m_file = nullptr;
+
+    m_offset += footer.size();
+    return isWritten;
+}
+
+bool DatasetReader::open(const std::string& path)
+{
+    close();
+
+    if (!m_file.open(path))
+        return false;
+
+    const std::uint8_t* data = m_file.data();
+    const std::size_t size = m_file.size();
+
+    if (size < DATASET_HEADER_SIZE + DATASET_FOOTER_SIZE || std::memcmp(data, headerMagic, 4) || readU32(data + 4) != DATASET_VERSION) {
+        close();
+        return false;
+    }
+
+    const std::uint8_t* footer = data + size - DATASET_FOOTER_SIZE;
+    std::uint64_t indexOffset = readU64(footer);
+    std::uint32_t chunkAmount = readU32(footer + 8);
+
+    if (std::memcmp(footer + 16, footerMagic, 4) || readU32(footer + 12) != DATASET_VERSION
+        || indexOffset < DATASET_HEADER_SIZE || indexOffset > size - DATASET_FOOTER_SIZE
+        || (size - DATASET_FOOTER_SIZE - indexOffset) != std::uint64_t(chunkAmount) * indexEntrySize) {
+        close();
+        return false;
+    }
+
+    m_chunks.reserve(chunkAmount);
+    for (std::uint32_t i = 0; i < chunkAmount; i++) {
+        const std::uint8_t* entry = data + indexOffset + std::size_t(i) * indexEntrySize;
+        std::uint64_t offset = readU64(entry);
+        std::uint32_t chunkSize = readU32(entry + 8);
+
+        if (offset < DATASET_HEADER_SIZE || chunkSize < std::uint32_t(chunkHeaderSize) || offset + chunkSize > indexOffset) {
+            close();
+            return false;
+        }
+
+        Chunk chunk = {data + offset, chunkSize, readU32(entry + 12), readU32(entry + 16), m_positionAmount};
+        m_chunks.push_back(chunk);
+        m_positionAmount += chunk.positionAmount;
+        m_gameAmount += chunk.gameAmount;
+    }
+
+    return true;
+}
+
+void DatasetReader::close()
+{
+    m_file.close();
+    m_chunks.clear();
+    m_positionAmount = 0;
+    m_gameAmount = 0;
+}
+
+bool DatasetReader::readChunk(int chunk, DatasetChunk& decoded) const
+{
+    decoded.clear();
+    if (chunk < 0 || chunk >= chunkAmount())
+        return false;
+
+    const std::uint8_t* data = m_chunks[std::size_t(chunk)].data;
+    const std::uint8_t* end = data + m_chunks[std::size_t(chunk)].size;
+
+    std::uint32_t gameAmount = readU32(data);
+    std::uint32_t positionAmount = readU32(data + 4);
+    std::uint32_t columnSizes[4];
+    std::uint64_t totalSize = chunkHeaderSize;
+    for (int i = 0; i < 4; i++) {
+        columnSizes[i] = readU32(data + 8 + 4 * i);
+        totalSize += columnSizes[i];
+    }
+
+    if (totalSize != std::uint64_t(end - data) || columnSizes[0] != std::uint64_t(gameAmount) * gameEntrySize)
+        return false;
+
+    const std::uint8_t* games = data + chunkHeaderSize;
+    const std::uint8_t* mines = games + columnSizes[0];
+    const std::uint8_t* visible = mines + columnSizes[1];
+    const std::uint8_t* labels = visible + columnSizes[2];
+
+    // Games column, and the sizes the other columns must decode to
+    std::size_t mineSize = 0, visibleSize = 0, labelSize = 0, cellSize = 0;
+    std::size_t firstPosition = 0;
+    decoded.games.resize(gameAmount);
+    for (std::uint32_t i = 0; i < gameAmount; i++) {
+        const std::uint8_t* entry = games + std::size_t(i) * gameEntrySize;
+        DatasetChunk::Game& game = decoded.games[i];
+        game.id = readU32(entry);
+        game.rowNumber = int(readU16(entry + 4));
+        game.columnNumber = int(readU16(entry + 6));
+        game.mineAmount = int(readU32(entry + 8));
+        game.positionAmount = int(readU32(entry + 12));
+        game.firstPosition = firstPosition;
+        game.cellOffset = std::size_t(i) ? decoded.games[i - 1].cellOffset + std::size_t(decoded.games[i - 1].rowNumber) * std::size_t(decoded.games[i - 1].columnNumber) : 0;
+
+        // Boards are indexed with int, like the Topology
+        std::size_t cellAmount = std::size_t(game.rowNumber) * std::size_t(game.columnNumber);
+        if (cellAmount > std::size_t(INT_MAX))
+            return false;
+        mineSize += mineBytes(cellAmount);
+        visibleSize += visibleBytes(cellAmount) * std::size_t(game.positionAmount);
+        labelSize += labelBytes(cellAmount) * std::size_t(game.positionAmount);
+        cellSize += std::size_t(cellAmount) * std::size_t(game.positionAmount);
+        firstPosition += std::size_t(game.positionAmount);
+    }
+
+    if (firstPosition != positionAmount || mineSize != columnSizes[1])
+        return false;
+
+    std::vector<std::uint8_t> visibleDeltas, labelDeltas;
+    if (!decodeZeroRuns(visible, columnSizes[2], visibleSize, visibleDeltas) || !decodeZeroRuns(labels, columnSizes[3], labelSize, labelDeltas))
+        return false;
+
+    decoded.mines.resize(decoded.games.empty() ? 0 : decoded.games.back().cellOffset + std::size_t(decoded.games.back().rowNumber) * std::size_t(decoded.games.back().columnNumber));
+    decoded.positionGames.resize(positionAmount);
+    decoded.cellOffsets.resize(std::size_t(positionAmount) + 1);
+    decoded.visible.resize(cellSize);
+    decoded.labels.resize(cellSize);
+
+    // Undo the XOR with the previous position while unpacking
+    const UnpackTables& tables = unpackTables();
+    const std::uint8_t* packedMines = mines;
+    std::size_t visibleOffset = 0, labelOffset = 0, cellOffset = 0;
+    std::vector<std::uint8_t> previousVisible, previousLabels;
+
+    for (std::uint32_t g = 0; g < gameAmount; g++) {
+        const DatasetChunk::Game& game = decoded.games[g];
+        const int cellAmount = int(std::size_t(game.rowNumber) * std::size_t(game.columnNumber));     // Checked above
+
+        unpackCells<8>(packedMines, tables.mines, cellAmount, decoded.mines.data() + game.cellOffset);
+        packedMines += mineBytes(cellAmount);
+
+        previousVisible.assign(visibleBytes(cellAmount), 0);
+        previousLabels.assign(labelBytes(cellAmount), 0);
+
+        for (int p = 0; p < game.positionAmount; p++) {
+            std::size_t position = game.firstPosition + std::size_t(p);
+            decoded.positionGames[position] = g;
+            decoded.cellOffsets[position] = cellOffset;
+
+            for (std::size_t i = 0; i < previousVisible.size(); i++)
+                previousVisible[i] ^= visibleDeltas[visibleOffset + i];
+            for (std::size_t i = 0; i < previousLabels.size(); i++)
+                previousLabels[i] ^= labelDeltas[labelOffset + i];
+            visibleOffset += previousVisible.size();
+            labelOffset += previousLabels.size();
+
+            unpackCells<2>(previousVisible.data(), tables.visible, cellAmount, decoded.visible.data() + cellOffset);
+            unpackCells<4>(previousLabels.data(), tables.labels, cellAmount, decoded.labels.data() + cellOffset);
+            cellOffset += std::size_t(cellAmount);
+        }
+    }
+    decoded.cellOffsets[positionAmount] = cellOffset;
+
+    return true;
+}
@@ -0,0 +1,182 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "board.h"
+#include "mappedfile.h"
+
+/*
+ * Columnar file format for positions of played games, used to train move prediction models
+ *
+ * A record is one position of a game: the visible state the player saw, the true mine layout
+ * and a label for every cell, safe or mine when the hint algorithm can prove it
+ *
+ * The file is a sequence of independent chunks followed by an index of the chunks:
+ *
+ *   "MSDS" version                          header, 8 bytes
+ *   chunk 0, chunk 1, ...                   written in any order by the generating threads
+ *   index entry of each chunk               offset, size, record and game amounts, in chunk number order
+ *   index offset, chunk amount, version, "MSDX"   footer, 20 bytes at the end of the file
+ *
+ * Inside a chunk each field is stored as its own column:
+ *
+ *   games     per game: id, rows, columns, mine amount, position amount
+ *   mines     per game: mine layout, one bit per cell
+ *   visible   per position: VisibleCell codes, 4 bits per cell
+ *   labels    per position: DatasetLabel codes, 2 bits per cell
+ *
+ * Positions of a game are consecutive and change little from one to the next, so the visible and label
+ * columns hold the XOR with the previous position of the same game; the long runs of zero bytes this makes
+ * are then run-length encoded
+ * Every number is little endian
+ */
+
+#define DATASET_VERSION 1
+#define DATASET_HEADER_SIZE 8
+#define DATASET_FOOTER_SIZE 20
+
+// Label of a cell in a position
+enum DatasetLabel : std::uint8_t {
+    LabelUnknown = 0,       // Revealed, a hole, or not decided by the hint algorithm
+    LabelSafe    = 1,       // Unrevealed cell proven to not contain a mine
+    LabelMine    = 2        // Unrevealed cell proven to contain a mine
+};
+
+// A decoded chunk, every column expanded to one byte per cell
+struct DatasetChunk
+{
+    struct Game
+    {
+        std::uint32_t id = 0;
+        int rowNumber = 0;
+        int columnNumber = 0;
+        int mineAmount = 0;
+        int positionAmount = 0;
+        std::size_t firstPosition = 0;      // Index of the first position of the game within the chunk
+        std::size_t cellOffset = 0;         // Offset of the mine layout in mines
+    };
+
+    std::vector<Game> games;
+    std::vector<std::uint8_t> mines;                // 1 on a cell with mine, games one after the other
+
+    std::vector<std::uint32_t> positionGames;       // Index in games of each position
+    std::vector<std::size_t> cellOffsets;           // Offset of each position in visible and labels, one more entry at the end
+    std::vector<std::uint8_t> visible;              // VisibleCell codes, positions one after the other
+    std::vector<std::uint8_t> labels;               // DatasetLabel codes, positions one after the other
+
+    std::size_t positionAmount() const { return positionGames.size(); }
+    void clear();
+};
+
+/*
+ * Collects the positions of whole games and encodes them into one chunk
+ * Every thread uses its own builder
+ */
+class DatasetChunkBuilder
+{
+public:
+    void beginGame(std::uint32_t id, const Board& board);      // Stores the mine layout, called once the mines are placed
+    void addPosition(const Board& board);                      // Stores the visible state and the labels of the current position
+
+    int gameAmount() const { return int(m_games.size()); }
+    int positionAmount() const { return m_positionAmount; }
+
+    void encode(std::vector<std::uint8_t>& chunk) const;       // Replaces the contents of chunk with the encoded chunk
+    void clear();                                              // Forgets every game, keeps the buffers
+
+private:
+    struct Game
+    {
+        std::uint32_t id;
+        int rowNumber;
+        int columnNumber;
+        int mineAmount;
+        int positionAmount;
+    };
+
+    std::vector<Game> m_games;
+    std::vector<std::uint8_t> m_mines;              // Packed mine layouts
+    std::vector<std::uint8_t> m_visibleDeltas;      // Packed visible states, XOR with the previous position
+    std::vector<std::uint8_t> m_labelDeltas;        // Packed labels, XOR with the previous position
+    std::vector<std::uint8_t> m_previousVisible;    // Packed visible state of the previous position of the game
+    std::vector<std::uint8_t> m_previousLabels;
+    std::vector<std::uint8_t> m_packed;             // Scratch buffer of addPosition()
+    int m_positionAmount = 0;
+};
+
+/*
+ * Writes encoded chunks to a file, any thread can write a chunk at any time
+ * Chunks are stored in the order they arrive and found through the index written by close()
+ */
+class DatasetWriter
+{
+public:
+    DatasetWriter() = default;
+    ~DatasetWriter();
+
+    DatasetWriter(const DatasetWriter&) = delete;
+    DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+    bool open(const std::string& path);
+    bool writeChunk(std::uint32_t chunkNumber, const std::vector<std::uint8_t>& chunk);    // chunkNumber gives the position in the index
+    bool close();                                                                          // Writes the index and closes the file
+
+    std::uint64_t writtenBytes() const { return m_offset; }
+
+private:
+    struct IndexEntry
+    {
+        std::uint64_t offset;
+        std::uint32_t size;
+        std::uint32_t positionAmount;
+        std::uint32_t gameAmount;
+    };
+
+    std::FILE* m_file = nullptr;
+    std::uint64_t m_offset = 0;                         // Where the next chunk goes
+    std::map<std::uint32_t, IndexEntry> m_index;        // Sorted by chunk number
+    bool m_isFailed = false;                            // A write failed, the file is incomplete
+    std::mutex m_mutex;
+};
+
+/*
+ * Reads a dataset file through a memory mapping
+ * Chunks are decoded straight from the mapping, readChunk() can be called from several threads at once
+ */
+class DatasetReader
+{
+public:
+    bool open(const std::string& path);     // Returns false if the file is missing or not a valid dataset
+    void close();
+
+    int chunkAmount() const { return int(m_chunks.size()); }
+    std::uint64_t positionAmount() const { return m_positionAmount; }
+    std::uint64_t gameAmount() const { return m_gameAmount; }
+    std::uint64_t chunkFirstPosition(int chunk) const { return m_chunks[chunk].firstPosition; }
+    std::uint32_t chunkPositionAmount(int chunk) const { return m_chunks[chunk].positionAmount; }
+    std::size_t fileSize() const { return m_file.size(); }
+
+    bool readChunk(int chunk, DatasetChunk& decoded) const;     // Returns false if the chunk is corrupt
+
+private:
+    struct Chunk
+    {
+        const std::uint8_t* data;
+        std::uint32_t size;
+        std::uint32_t positionAmount;
+        std::uint32_t gameAmount;
+        std::uint64_t firstPosition;    // Number of positions in the chunks before it
+    };
+
+    MappedFile m_file;
+    std::vector<Chunk> m_chunks;
+    std::uint64_t m_positionAmount = 0;
+    std::uint64_t m_gameAmount = 0;
+};
+
+#endif // DATASET_H
@@ -0,0 +1,17 @@
+# Exports positions of played games to a columnar dataset file and reads them back
+
+TEMPLATE = app
+TARGET = dataset
+CONFIG += console c++17 thread
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    dataset.cpp \
+    main.cpp \
+    mappedfile.cpp
+
+HEADERS += \
+    dataset.h \
+    mappedfile.h
@@ -0,0 +1,256 @@
+#include "dataset.h"
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+
+/*
+ * Exports positions of played games to a dataset file, and reads a dataset file back
+ *
+ * export: every game gets its own seed, so a game is the same whatever the thread amount is
+ *         games are played like in the selfplay tool: opened on a random empty cell, then the hint is followed
+ *         and a random unknown cell is guessed when there is no hint
+ *         every position before a move is recorded, labelled with the marks of the hint algorithm
+ * read:   decodes every chunk, checks the labels against the mine layouts and reports the decoding speed
+ *
+ * Usage: dataset export FILE [--games N] [--rows R] [--columns C] [--mines M] [--seed S] [--threads T] [--chunk-games G]
+ *        dataset read FILE [--threads T]
+ */
+
+namespace {
+
+struct Options
+{
+    bool isExport = true;
+    std::string path;
+    int games = 10000;
+    int rows = 16;
+    int columns = 30;
+    int mines = 99;
+    std::uint32_t seed = 1;
+    int threads = 0;                // 0 uses every hardware thread
+    int chunkGames = 256;           // Games in each chunk
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    if (argc < 3)
+        return false;
+
+    if (!std::strcmp(argv[1], "read"))
+        options.isExport = false;
+    else if (std::strcmp(argv[1], "export"))
+        return false;
+    options.path = argv[2];
+
+    for (int i = 3; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--games") && hasValue)
+            options.games = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--rows") && hasValue)
+            options.rows = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--columns") && hasValue)
+            options.columns = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--mines") && hasValue)
+            options.mines = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seed") && hasValue)
+            options.seed = std::uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--threads") && hasValue)
+            options.threads = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--chunk-games") && hasValue)
+            options.chunkGames = std::atoi(argv[++i]);
+        else
+            return false;
+    }
+
+    if (options.threads <= 0)
+        options.threads = std::max(1, int(std::thread::hardware_concurrency()));
+    if (options.chunkGames <= 0)
+        options.chunkGames = 1;
+    // The file stores 16-bit dimensions, boards are indexed with int
+    return options.rows > 0 && options.columns > 0 && options.rows < 65536 && options.columns < 65536
+           && std::int64_t(options.rows) * options.columns <= INT_MAX;
+}
+
+// Plays one game and adds its positions to the builder
+void playGame(const Topology& topology, const Options& options, std::uint32_t game, DatasetChunkBuilder& builder)
+{
+    std::uint32_t seed = options.seed + game;
+
+    Board board(topology);
+    board.generateMines(options.mines, seed);
+    board.setMineNumbers();
+
+    std::vector<int> emptyCells;
+    for (int i = 0; i < topology.cellAmount(); i++) {
+        if (topology.isActive(i) && !board.isMine(i) && board.numberOfNeighbouringMines(i) == 0)
+            emptyCells.push_back(i);
+    }
+    if (emptyCells.empty())
+        return;
+
+    // Moves use a generator of their own, seeded apart from the mine layout
+    std::mt19937 mt{seed ^ 0x9e3779b9u};
+    std::uniform_int_distribution<> randomCell{0, topology.cellAmount() - 1};
+    std::vector<int> revealedCells;
+
+    builder.beginGame(game, board);
+    board.reveal(emptyCells[std::size_t(randomCell(mt)) % emptyCells.size()], revealedCells);
+
+    while (board.status() == GameStatus::Playing) {
+
+        // findHint() marks every deduction first, so the labels are complete
+        int hint = board.findHint();
+        builder.addPosition(board);
+
+        if (hint >= 0) {
+            board.reveal(hint, revealedCells);
+            continue;
+        }
+
+        int guess;
+        do {
+            guess = randomCell(mt);
+        } while (!topology.isActive(guess) || board.isRevealed(guess) || board.isMarkedUnsafe(guess));
+        board.reveal(guess, revealedCells);
+    }
+}
+
+/*
+ * Chunks are handed out to the threads one by one, each thread plays and encodes the games of its chunk
+ * and writes it, so the only shared work is the file write itself
+ */
+int exportDataset(const Options& options)
+{
+    DatasetWriter writer;
+    if (!writer.open(options.path)) {
+        std::fprintf(stderr, "can't open %s\n", options.path.c_str());
+        return 1;
+    }
+
+    Topology topology = Topology::rectangle(options.rows, options.columns);
+    int chunkAmount = (options.games + options.chunkGames - 1) / options.chunkGames;
+
+    std::atomic<int> nextChunk{0};
+    std::atomic<std::uint64_t> positions{0};
+    std::atomic<bool> isFailed{false};
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < options.threads; t++) {
+        threads.emplace_back([&]() {
+            DatasetChunkBuilder builder;
+            std::vector<std::uint8_t> chunk;
+
+            for (int c = nextChunk++; c < chunkAmount && !isFailed; c = nextChunk++) {
+                builder.clear();
+                int lastGame = std::min(options.games, (c + 1) * options.chunkGames);
+                for (int game = c * options.chunkGames; game < lastGame; game++)
+                    playGame(topology, options, std::uint32_t(game), builder);
+
+                builder.encode(chunk);
+                if (!writer.writeChunk(std::uint32_t(c), chunk))
+                    isFailed = true;
+                positions += std::uint64_t(builder.positionAmount());
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    if (!writer.close() || isFailed) {
+        std::fprintf(stderr, "can't write %s\n", options.path.c_str());
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::uint64_t cells = positions * std::uint64_t(topology.cellAmount());
+
+    std::printf("games       %d (%dx%d, %d mines)\n", options.games, options.rows, options.columns, options.mines);
+    std::printf("positions   %llu in %d chunks\n", (unsigned long long)positions, chunkAmount);
+    std::printf("file size   %.2f MB (%.3f bytes per cell)\n", writer.writtenBytes() / 1e6, cells ? double(writer.writtenBytes()) / double(cells) : 0.0);
+    std::printf("time        %.3f s on %d threads (%.0f positions per second)\n", seconds, options.threads, seconds > 0 ? positions / seconds : 0.0);
+    return 0;
+}
+
+// Decodes the chunks in parallel, a label that disagrees with the mine layout means the file or the hint algorithm is wrong
+int readDataset(const Options& options)
+{
+    DatasetReader reader;
+    if (!reader.open(options.path)) {
+        std::fprintf(stderr, "%s is not a dataset file\n", options.path.c_str());
+        return 1;
+    }
+
+    std::atomic<int> nextChunk{0};
+    std::atomic<bool> isCorrupt{false};
+    std::atomic<std::uint64_t> wrongLabels{0};
+    std::atomic<std::uint64_t> labels{0};
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < options.threads; t++) {
+        threads.emplace_back([&]() {
+            DatasetChunk chunk;
+            for (int c = nextChunk++; c < reader.chunkAmount(); c = nextChunk++) {
+                if (!reader.readChunk(c, chunk)) {
+                    isCorrupt = true;
+                    continue;
+                }
+
+                std::uint64_t wrong = 0, labelled = 0;
+                for (std::size_t p = 0; p < chunk.positionAmount(); p++) {
+                    const DatasetChunk::Game& game = chunk.games[chunk.positionGames[p]];
+                    const std::uint8_t* cellLabels = chunk.labels.data() + chunk.cellOffsets[p];
+                    const std::uint8_t* mines = chunk.mines.data() + game.cellOffset;
+
+                    for (std::size_t i = 0; i < chunk.cellOffsets[p + 1] - chunk.cellOffsets[p]; i++) {
+                        if (cellLabels[i] == LabelUnknown)
+                            continue;
+                        labelled++;
+                        if ((cellLabels[i] == LabelMine) != (mines[i] == 1))
+                            wrong++;
+                    }
+                }
+                wrongLabels += wrong;
+                labels += labelled;
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("games       %llu\n", (unsigned long long)reader.gameAmount());
+    std::printf("positions   %llu in %d chunks\n", (unsigned long long)reader.positionAmount(), reader.chunkAmount());
+    std::printf("labels      %llu, %llu wrong\n", (unsigned long long)labels.load(), (unsigned long long)wrongLabels.load());
+    std::printf("time        %.3f s on %d threads (%.0f positions per second, %.0f MB/s)\n", seconds, options.threads,
+                seconds > 0 ? reader.positionAmount() / seconds : 0.0, seconds > 0 ? reader.fileSize() / seconds / 1e6 : 0.0);
+
+    if (isCorrupt) {
+        std::fprintf(stderr, "corrupt chunks in %s\n", options.path.c_str());
+        return 1;
+    }
+    return wrongLabels ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: dataset export FILE [--games N] [--rows R] [--columns C] [--mines M] [--seed S] [--threads T] [--chunk-games G]\n"
+                             "       dataset read FILE [--threads T]\n");
+        return 2;
+    }
+
+    return options.isExport ? exportDataset(options) : readDataset(options);
+}
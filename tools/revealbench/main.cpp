@@ -0,0 +1,138 @@
+#include "board.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+/*
+ * Compares giant openings revealed on one thread with the same openings continued on every core by the waves
+ * of Board::reveal()
+ *
+ * Rows of mines every --band rows split the board into bands, and a few random mines are scattered inside them,
+ * so that one click opens most of a band (narrow bands never reach a front wide enough for the waves, which
+ * makes them a measure of the cost of the checks alone). Both boards click the same cells in the same order, the first
+ * opening of the parallel board also pays for the pool threads and the bids of the waves
+ * Every reveal is checked to give the same cells in the same order, and the boards to end up the same
+ *
+ * Usage: revealbench [--rows R] [--columns C] [--band B] [--mines M] [--seed S] [--threads T]
+ */
+
+namespace {
+
+struct Options
+{
+    int rows = 4096;
+    int columns = 4096;
+    int band = 2048;                // Rows between two rows of mines, the waves need a front of 4096 cells
+    int mines = 20000;              // Scattered mines, besides the rows of mines
+    std::uint32_t seed = 1;
+    int threads = 0;                // 0 uses one per core
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--rows") && hasValue)
+            options.rows = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--columns") && hasValue)
+            options.columns = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--band") && hasValue)
+            options.band = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--mines") && hasValue)
+            options.mines = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seed") && hasValue)
+            options.seed = std::uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--threads") && hasValue)
+            options.threads = std::atoi(argv[++i]);
+        else
+            return false;
+    }
+
+    return options.rows > 0 && options.columns > 0 && options.band > 1 && options.mines >= 0
+           && std::int64_t(options.rows) * options.columns <= 1 << 30;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: revealbench [--rows R] [--columns C] [--band B] [--mines M] [--seed S] [--threads T]\n");
+        return 2;
+    }
+
+    Topology topology = Topology::rectangle(options.rows, options.columns);
+    Board layout(topology);
+    for (int row = options.band; row < options.rows; row += options.band) {
+        for (int column = 0; column < options.columns; column++)
+            layout.setMine(topology.indexOf(row, column), true);
+    }
+
+    std::mt19937 mt{options.seed};
+    std::uniform_int_distribution<> randomCell{0, topology.cellAmount() - 1};
+    for (int i = 0; i < options.mines; i++)
+        layout.setMine(randomCell(mt), true);
+    layout.setMineNumbers();
+
+    Board sequential = layout;
+    sequential.setRevealThreadAmount(1);
+    Board parallel = layout;
+    parallel.setRevealThreadAmount(options.threads);
+
+    // One click per band, on a cell without neighbouring mine
+    std::vector<int> clicks;
+    for (int row = 0; row < options.rows; row += options.band) {
+        for (int cell = topology.indexOf(row, 0); cell < topology.indexOf(std::min(row + options.band, options.rows), 0); cell++) {
+            if (!layout.isMine(cell) && layout.numberOfNeighbouringMines(cell) == 0) {
+                clicks.push_back(cell);
+                break;
+            }
+        }
+    }
+
+    std::vector<int> sequentialCells, parallelCells;
+    std::chrono::duration<double> sequentialTime{0}, parallelTime{0}, firstParallelTime{0};
+    long long openedCells = 0;
+    int mismatches = 0;
+
+    for (std::size_t i = 0; i < clicks.size(); i++) {
+        sequentialCells.clear();
+        parallelCells.clear();
+
+        auto start = std::chrono::steady_clock::now();
+        sequential.reveal(clicks[i], sequentialCells);
+        auto middle = std::chrono::steady_clock::now();
+        parallel.reveal(clicks[i], parallelCells);
+        auto end = std::chrono::steady_clock::now();
+
+        sequentialTime += middle - start;
+        parallelTime += end - middle;
+        if (i == 0)
+            firstParallelTime = end - middle;
+        openedCells += static_cast<long long>(sequentialCells.size());
+        if (sequentialCells != parallelCells)
+            mismatches++;
+    }
+
+    if (std::memcmp(sequential.visibleState(), parallel.visibleState(), std::size_t(topology.cellAmount()))
+            || sequential.revealedCellAmount() != parallel.revealedCellAmount())
+        mismatches++;
+
+    double sequentialMs = sequentialTime.count() * 1e3;
+    double parallelMs = parallelTime.count() * 1e3;
+    std::printf("board       %dx%d, %zu openings of %.0f cells on average\n", options.rows, options.columns, clicks.size(),
+                clicks.empty() ? 0.0 : double(openedCells) / clicks.size());
+    std::printf("sequential  %.1f ms (%.1f ns per cell)\n", sequentialMs, openedCells ? sequentialMs * 1e6 / openedCells : 0.0);
+    std::printf("parallel    %.1f ms (%.1f ns per cell), first opening %.1f ms, threads %s\n", parallelMs,
+                openedCells ? parallelMs * 1e6 / openedCells : 0.0, firstParallelTime.count() * 1e3,
+                options.threads > 0 ? std::to_string(options.threads).c_str() : "one per core");
+    std::printf("speedup     %.2fx\n", parallelMs > 0 ? sequentialMs / parallelMs : 0.0);
+    std::printf("mismatches  %d\n", mismatches);
+
+    return mismatches ? 1 : 0;
+}
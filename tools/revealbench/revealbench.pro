@@ -0,0 +1,11 @@
+# Times giant openings revealed on one thread and continued on every core
+
+TEMPLATE = app
+TARGET = revealbench
+CONFIG += console c++17 thread
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,157 @@
+#include "board.h"
+#include "endgamesolver.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+/*
+ * Plays games by always following the hint, and guessing a random unknown cell when there is no hint
+ * With --endgame, the guess is searched by the EndgameSolver once the unknown region has at most that many cells
+ * Reports the win rate, the time spent in Board::findHint() and the statistics of the deduction cache
+ *
+ * Usage: selfplay [--games N] [--rows R] [--columns C] [--mines M] [--seed S] [--no-cache] [--endgame CELLS]
+ */
+
+namespace {
+
+struct Options
+{
+    int games = 1000;
+    int rows = 16;
+    int columns = 30;
+    int mines = 99;
+    std::uint32_t seed = 1;
+    bool useCache = true;
+    int endgameCells = 0;           // 0 always guesses at random
+};
+
+Options parseOptions(int argc, char* argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--games") && hasValue)
+            options.games = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--rows") && hasValue)
+            options.rows = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--columns") && hasValue)
+            options.columns = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--mines") && hasValue)
+            options.mines = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seed") && hasValue)
+            options.seed = std::uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--no-cache"))
+            options.useCache = false;
+        else if (!std::strcmp(argv[i], "--endgame") && hasValue)
+            options.endgameCells = std::atoi(argv[++i]);
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options = parseOptions(argc, argv);
+    Topology topology = Topology::rectangle(options.rows, options.columns);
+
+    DeductionCache& cache = DeductionCache::shared();
+    std::mt19937 mt{options.seed};
+
+    EndgameSolver endgameSolver;
+    endgameSolver.setMaxUnknownCells(options.endgameCells);
+
+    int wins = 0;
+    long long hints = 0;
+    long long endgameGuesses = 0;
+    long long endgameTimeouts = 0;  // Guesses whose search finished no cell, they are the safest cell
+    double endgameWinChance = 0;    // Sum of the win probabilities of the other searched guesses
+    std::chrono::nanoseconds solverTime{0};
+    std::chrono::nanoseconds endgameTime{0};
+
+    for (int game = 0; game < options.games; game++) {
+
+        Board board(topology);
+        board.setDeductionCache(options.useCache ? &cache : nullptr);
+        board.generateMines(options.mines, options.seed + std::uint32_t(game));
+        board.setMineNumbers();
+
+        std::vector<int> revealedCells;
+        std::uniform_int_distribution<> randomCell{0, topology.cellAmount() - 1};
+
+        // The game is opened on a random empty cell, so that every game gets past the first click
+        std::vector<int> emptyCells;
+        for (int i = 0; i < topology.cellAmount(); i++) {
+            if (!board.isMine(i) && board.numberOfNeighbouringMines(i) == 0)
+                emptyCells.push_back(i);
+        }
+        if (emptyCells.empty())
+            continue;
+        board.reveal(emptyCells[std::size_t(randomCell(mt)) % emptyCells.size()], revealedCells);
+
+        while (board.status() == GameStatus::Playing) {
+
+            auto start = std::chrono::steady_clock::now();
+            int hint = board.findHint();
+            solverTime += std::chrono::steady_clock::now() - start;
+
+            if (hint >= 0) {
+                hints++;
+                board.reveal(hint, revealedCells);
+                continue;
+            }
+
+            if (options.endgameCells > 0) {
+                start = std::chrono::steady_clock::now();
+                EndgameResult result = endgameSolver.solve(board);
+                endgameTime += std::chrono::steady_clock::now() - start;
+
+                if (result.cell >= 0) {
+                    endgameGuesses++;
+                    if (result.isWinProbabilityKnown)
+                        endgameWinChance += result.winProbability;
+                    else
+                        endgameTimeouts++;
+                    board.reveal(result.cell, revealedCells);
+                    continue;
+                }
+            }
+
+            // No safe cell is known, guess one that is not deduced as a mine
+            int guess;
+            do {
+                guess = randomCell(mt);
+            } while (board.isRevealed(guess) || board.isMarkedUnsafe(guess));
+            board.reveal(guess, revealedCells);
+        }
+
+        if (board.status() == GameStatus::Won)
+            wins++;
+    }
+
+    const DeductionCache::Statistics& statistics = cache.statistics();
+    std::uint64_t lookups = statistics.hits + statistics.misses;
+
+    std::printf("games       %d (%dx%d, %d mines)\n", options.games, options.rows, options.columns, options.mines);
+    std::printf("wins        %d (%.1f%%)\n", wins, options.games ? 100.0 * wins / options.games : 0.0);
+    std::printf("hints       %lld\n", hints);
+    std::printf("solver time %.3f ms (%.2f us per hint)\n", solverTime.count() / 1e6, hints ? solverTime.count() / 1e3 / hints : 0.0);
+    if (options.endgameCells > 0) {
+        long long searchedGuesses = endgameGuesses - endgameTimeouts;
+        std::printf("endgame     %lld guesses, %.1f%% mean win chance, %lld timed out, %.3f ms (%.2f ms per guess)\n", endgameGuesses,
+                    searchedGuesses ? 100.0 * endgameWinChance / searchedGuesses : 0.0, endgameTimeouts, endgameTime.count() / 1e6,
+                    endgameGuesses ? endgameTime.count() / 1e6 / endgameGuesses : 0.0);
+    }
+    if (options.useCache) {
+        std::printf("cache       %llu hits, %llu misses, %llu evictions (%.1f%% hit rate)\n",
+                    (unsigned long long)statistics.hits, (unsigned long long)statistics.misses,
+                    (unsigned long long)statistics.evictions, lookups ? 100.0 * statistics.hits / lookups : 0.0);
+    }
+    else {
+        std::printf("cache       disabled\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,11 @@
+# Plays seeded games with the hint algorithm and reports the time spent in the solver
+
+TEMPLATE = app
+TARGET = selfplay
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,238 @@
+#include "corpus.h"
+#include "exactsolver.h"
+#include <fstream>
+#include <random>
+#include <sstream>
+
+/*
+ * This file provides implementations for reading and writing the solver benchmark corpus declared in corpus.h
+ */
+
+/*
+ * Positions come from real games, so every revealed empty cell has only revealed neighbours
+ * and revealing the cells one by one gives back exactly the same revealed set
+ */
+Board CorpusPosition::makeBoard() const
+{
+    Board board(Topology::rectangle(rowNumber, columnNumber));
+    for (int i = 0; i < rowNumber * columnNumber; i++)
+        board.setMine(i, mines[std::size_t(i)] != 0);
+    board.setMineNumbers();
+
+    std::vector<int> revealedCells;
+    if (!clicks.empty()) {
+        for (int click : clicks)
+            board.reveal(click, revealedCells);
+        return board;
+    }
+
+    for (int i = 0; i < rowNumber * columnNumber; i++) {
+        if (revealed[std::size_t(i)])
+            board.reveal(i, revealedCells);
+    }
+    return board;
+}
+
+// std::mt19937 gives the same numbers everywhere, the remainder of its output picks the cell
+void seedMines(Board& board, int mineAmount, std::uint32_t seed)
+{
+    int cellAmount = board.topology().cellAmount();
+    if (mineAmount > cellAmount)
+        mineAmount = cellAmount;
+
+    std::mt19937 mt{seed};
+    while (mineAmount > 0) {
+        int index = int(mt() % std::uint32_t(cellAmount));
+        if (board.isMine(index))
+            continue;
+        board.setMine(index, true);
+        mineAmount--;
+    }
+}
+
+namespace {
+
+// Reads "<keyword> <amount> <cell> ...", false if the keyword differs or a cell is outside the board
+bool readCells(std::istream& file, const char* keyword, std::size_t cellAmount, std::vector<int>& cells)
+{
+    std::string word;
+    std::size_t amount = 0;
+    if (!(file >> word >> amount) || word != keyword || amount > cellAmount)
+        return false;
+
+    cells.resize(amount);
+    for (int& cell : cells) {
+        if (!(file >> cell) || cell < 0 || std::size_t(cell) >= cellAmount)
+            return false;
+    }
+    return true;
+}
+
+void writeCells(std::ostream& file, const char* keyword, const std::vector<int>& cells)
+{
+    file << keyword << " " << cells.size();
+    for (int cell : cells)
+        file << " " << cell;
+    file << "\n";
+}
+
+/*
+ * Rebuilds a position stored as a replay: places the mines, replays the clicks and sets the labels
+ * Fails if a click hits a mine, the game has to be going on at the position
+ */
+bool readReplay(std::istream& file, CorpusPosition& position)
+{
+    std::size_t cellAmount = std::size_t(position.rowNumber) * std::size_t(position.columnNumber);
+    std::vector<int> safeCells;
+    std::vector<int> mineCells;
+    if (!(file >> position.mineAmount >> position.mineSeed) || position.mineAmount < 0
+        || !readCells(file, "clicks", cellAmount, position.clicks) || position.clicks.empty()
+        || !readCells(file, "safe", cellAmount, safeCells) || !readCells(file, "mine", cellAmount, mineCells))
+        return false;
+
+    Board board(Topology::rectangle(position.rowNumber, position.columnNumber));
+    seedMines(board, position.mineAmount, position.mineSeed);
+    board.setMineNumbers();
+    std::vector<int> revealedCells;
+    for (int click : position.clicks) {
+        if (board.reveal(click, revealedCells) != GameStatus::Playing)
+            return false;
+    }
+
+    for (std::size_t i = 0; i < cellAmount; i++) {
+        position.mines[i] = board.isMine(int(i));
+        position.revealed[i] = board.isRevealed(int(i));
+    }
+    for (int cell : safeCells)
+        position.labels[std::size_t(cell)] = ExactSolver::Safe;
+    for (int cell : mineCells)
+        position.labels[std::size_t(cell)] = ExactSolver::Mine;
+    return true;
+}
+
+} // namespace
+
+bool loadCorpus(const std::string& path, std::vector<CorpusPosition>& positions, std::string& error)
+{
+    std::ifstream file(path);
+    if (!file) {
+        error = "can't open " + path;
+        return false;
+    }
+
+    std::string header;
+    int version = 0;
+    file >> header >> version;
+    if (header != "minesweeper-solver-corpus" || version != CORPUS_VERSION) {
+        error = path + " is not a version " + std::to_string(CORPUS_VERSION) + " corpus";
+        return false;
+    }
+
+    positions.clear();
+    std::string keyword;
+    while (file >> keyword) {
+        CorpusPosition position;
+        bool isReplay = keyword == "replay";
+        if ((keyword != "position" && !isReplay) || !(file >> position.tier >> position.rowNumber >> position.columnNumber)
+            || position.rowNumber <= 0 || position.columnNumber <= 0) {
+            error = "malformed position " + std::to_string(positions.size());
+            return false;
+        }
+
+        std::size_t cellAmount = std::size_t(position.rowNumber) * std::size_t(position.columnNumber);
+        position.mines.assign(cellAmount, 0);
+        position.revealed.assign(cellAmount, 0);
+        position.labels.assign(cellAmount, ExactSolver::Unknown);
+
+        if (isReplay) {
+            if (!readReplay(file, position)) {
+                error = "malformed replay of position " + std::to_string(positions.size());
+                return false;
+            }
+            positions.push_back(position);
+            continue;
+        }
+
+        for (int row = 0; row < position.rowNumber; row++) {
+            std::string line;
+            if (!(file >> line) || int(line.size()) != position.columnNumber) {
+                error = "malformed row " + std::to_string(row) + " of position " + std::to_string(positions.size());
+                return false;
+            }
+
+            for (int column = 0; column < position.columnNumber; column++) {
+                std::size_t i = std::size_t(row) * std::size_t(position.columnNumber) + std::size_t(column);
+                char c = line[std::size_t(column)];
+
+                if (c >= '0' && c <= '8')
+                    position.revealed[i] = 1;
+                else if (c == 's')
+                    position.labels[i] = ExactSolver::Safe;
+                else if (c == 'm' || c == '*')
+                    position.mines[i] = 1;
+                else if (c != '.') {
+                    error = std::string("unknown cell '") + c + "' in position " + std::to_string(positions.size());
+                    return false;
+                }
+
+                if (c == 'm')
+                    position.labels[i] = ExactSolver::Mine;
+            }
+        }
+
+        positions.push_back(position);
+    }
+
+    return true;
+}
+
+bool saveCorpus(const std::string& path, const std::vector<CorpusPosition>& positions)
+{
+    std::ofstream file(path);
+    if (!file)
+        return false;
+
+    file << "minesweeper-solver-corpus " << CORPUS_VERSION << "\n";
+
+    for (const CorpusPosition& position : positions) {
+        if (!position.clicks.empty()) {
+            std::vector<int> safeCells;
+            std::vector<int> mineCells;
+            for (std::size_t i = 0; i < position.labels.size(); i++) {
+                if (position.labels[i] == ExactSolver::Safe)
+                    safeCells.push_back(int(i));
+                else if (position.labels[i] == ExactSolver::Mine)
+                    mineCells.push_back(int(i));
+            }
+
+            file << "replay " << position.tier << " " << position.rowNumber << " " << position.columnNumber << " "
+                 << position.mineAmount << " " << position.mineSeed << "\n";
+            writeCells(file, "clicks", position.clicks);
+            writeCells(file, "safe", safeCells);
+            writeCells(file, "mine", mineCells);
+            continue;
+        }
+
+        Board board = position.makeBoard();
+        file << "position " << position.tier << " " << position.rowNumber << " " << position.columnNumber << "\n";
+
+        for (int row = 0; row < position.rowNumber; row++) {
+            std::string line(std::size_t(position.columnNumber), '.');
+            for (int column = 0; column < position.columnNumber; column++) {
+                std::size_t i = std::size_t(row) * std::size_t(position.columnNumber) + std::size_t(column);
+
+                if (position.revealed[i])
+                    line[std::size_t(column)] = char('0' + board.numberOfNeighbouringMines(int(i)));
+                else if (position.labels[i] == ExactSolver::Safe)
+                    line[std::size_t(column)] = 's';
+                else if (position.labels[i] == ExactSolver::Mine)
+                    line[std::size_t(column)] = 'm';
+                else if (position.mines[i])
+                    line[std::size_t(column)] = '*';
+            }
+            file << line << "\n";
+        }
+    }
+
+    return bool(file);
+}
@@ -0,0 +1,54 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "board.h"
+
+/*
+ * Positions of the solver benchmark, stored as text so that changes to the corpus can be reviewed
+ *
+ *   minesweeper-solver-corpus <version>
+ *   position <tier> <rows> <columns>
+ *   one line per row, one character per cell
+ *   ...
+ *
+ * Revealed cells are written as their number '0' ... '8'
+ * Unrevealed cells: 's' provably safe, 'm' provably mine, '.' undecided and safe, '*' undecided and mine
+ *
+ * Rows of a million cells would make the corpus too large to keep in the repository, giant positions are
+ * stored by how they were played instead, with cell indices counted row by row:
+ *
+ *   replay <tier> <rows> <columns> <mine amount> <seed>   mines placed by seedMines()
+ *   clicks <amount> <cell> ...                            revealed one after the other
+ *   safe <amount> <cell> ...                              provably safe cells
+ *   mine <amount> <cell> ...                              provably mined cells
+ */
+
+#define CORPUS_VERSION 1
+
+struct CorpusPosition
+{
+    std::string tier;                       // beginner, intermediate, expert or giant
+    int rowNumber = 0;
+    int columnNumber = 0;
+    std::vector<std::uint8_t> mines;        // 1 on a cell with mine
+    std::vector<std::uint8_t> revealed;     // 1 on a revealed cell
+    std::vector<std::uint8_t> labels;       // ExactSolver::Label of each cell
+
+    // Set on positions stored as a replay, the mines and revealed cells follow from them
+    int mineAmount = 0;
+    std::uint32_t mineSeed = 0;
+    std::vector<int> clicks;
+
+    Board makeBoard() const;                // Places the mines and reveals the cells, the game is still playing
+};
+
+// Places the mines from the seed, the same on every platform unlike the distributions of Board::generateMines()
+void seedMines(Board& board, int mineAmount, std::uint32_t seed);
+
+bool loadCorpus(const std::string& path, std::vector<CorpusPosition>& positions, std::string& error);
+bool saveCorpus(const std::string& path, const std::vector<CorpusPosition>& positions);
+
+#endif // CORPUS_H
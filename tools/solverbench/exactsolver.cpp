@@ -0,0 +1,323 @@
+#include "exactsolver.h"
+
+/*
+ * This file provides implementations for the member functions of ExactSolver class declared in exactsolver.h
+ */
+
+#define LOCAL_REFUTATION_DEPTH 8           // Rings of numbers around a cell tried before searching the whole group
+#define LOCAL_REFUTATION_VARIABLES 256    // Stops widening the rings past this many cells
+
+bool ExactSolver::solve(const Board& board, std::vector<std::uint8_t>& labels)
+{
+    const Topology& topology = board.topology();
+    const int cellAmount = topology.cellAmount();
+
+    labels.assign(std::size_t(cellAmount), Unknown);
+
+    auto isNumber = [&](int index) { return board.isRevealed(index) && !board.isMine(index); };
+    auto isHiddenCell = [&](int index) { return topology.isActive(index) && !board.isRevealed(index); };
+
+    std::vector<int> variableOf(std::size_t(cellAmount), -1);
+    std::vector<int> constraintOf(std::size_t(cellAmount), -1);
+    std::vector<char> isVisited(std::size_t(cellAmount), 0);
+    bool isOverLimit = false;
+
+    Problem group;
+    std::vector<int> cells;
+    std::vector<std::uint8_t> seenValues;
+
+    for (int start = 0; start < cellAmount; start++) {
+
+        if (isVisited[std::size_t(start)] || !isHiddenCell(start))
+            continue;
+
+        // Only unrevealed cells next to a number take part
+        bool isFrontier = false;
+        for (const std::uint32_t* n = topology.neighboursBegin(start); n != topology.neighboursEnd(start) && !isFrontier; ++n)
+            isFrontier = isNumber(int(*n));
+        if (!isFrontier)
+            continue;
+
+        // Collect the group: unrevealed cells and numbers reachable through each other
+        cells.clear();
+        std::vector<int> numbers;
+        std::vector<int> queue = {start};
+        isVisited[std::size_t(start)] = 1;
+
+        for (std::size_t head = 0; head < queue.size(); head++) {
+            int cell = queue[head];
+            variableOf[std::size_t(cell)] = int(cells.size());
+            cells.push_back(cell);
+
+            for (const std::uint32_t* n = topology.neighboursBegin(cell); n != topology.neighboursEnd(cell); ++n) {
+                int number = int(*n);
+                if (!isNumber(number) || constraintOf[std::size_t(number)] >= 0)
+                    continue;
+
+                constraintOf[std::size_t(number)] = int(numbers.size());
+                numbers.push_back(number);
+
+                for (const std::uint32_t* m = topology.neighboursBegin(number); m != topology.neighboursEnd(number); ++m) {
+                    if (isHiddenCell(int(*m)) && !isVisited[*m]) {
+                        isVisited[*m] = 1;
+                        queue.push_back(int(*m));
+                    }
+                }
+            }
+        }
+
+        group.constraints.clear();
+        group.variableConstraints.assign(cells.size(), std::vector<int>());
+        for (int number : numbers) {
+            Problem::Constraint constraint;
+            constraint.number = board.numberOfNeighbouringMines(number);
+            for (const std::uint32_t* m = topology.neighboursBegin(number); m != topology.neighboursEnd(number); ++m) {
+                if (isHiddenCell(int(*m))) {
+                    group.variableConstraints[std::size_t(variableOf[*m])].push_back(int(group.constraints.size()));
+                    constraint.variables.push_back(variableOf[*m]);
+                }
+            }
+            group.constraints.push_back(constraint);
+        }
+
+        solveGroup(group, seenValues, isOverLimit);
+
+        for (std::size_t v = 0; v < cells.size(); v++) {
+            if (seenValues[v] == 1)
+                labels[std::size_t(cells[v])] = Safe;
+            else if (seenValues[v] == 2)
+                labels[std::size_t(cells[v])] = Mine;
+        }
+    }
+
+    return !isOverLimit;
+}
+
+/*
+ * seenValues gets bit 0 for each variable that is empty in some layout and bit 1 if it is mined in some layout
+ * A group without any layout (a contradiction) leaves every variable at 3, nothing is concluded
+ */
+void ExactSolver::solveGroup(Problem& group, std::vector<std::uint8_t>& seenValues, bool& isOverLimit) const
+{
+    const std::size_t variableAmount = group.variableConstraints.size();
+
+    std::vector<int> solution;
+    auto record = [&]() {
+        for (std::size_t v = 0; v < variableAmount; v++)
+            seenValues[v] |= std::uint8_t(1 << solution[v]);
+    };
+
+    seenValues.assign(variableAmount, 0);
+    group.reset();
+    if (!group.search(solution, m_nodeLimit)) {
+        seenValues.assign(variableAmount, 3);
+        isOverLimit = isOverLimit || group.nodes > m_nodeLimit;
+        return;
+    }
+    record();
+
+    for (std::size_t v = 0; v < variableAmount; v++) {
+        if (seenValues[v] == 3)
+            continue;
+
+        // Look for a layout where the variable has the value not seen yet, unless the numbers nearby rule it out
+        int opposite = seenValues[v] == 1 ? 1 : 0;
+        if (isRefutedLocally(group, int(v), opposite))
+            continue;
+
+        group.reset();
+        if (group.assign(int(v), opposite) && group.search(solution, m_nodeLimit))
+            record();
+        else if (group.nodes > m_nodeLimit) {
+            seenValues[v] = 3;          // Undecided, don't claim anything
+            isOverLimit = true;
+        }
+    }
+}
+
+/*
+ * Builds the problem made of the numbers within a few rings of the variable (each ring adds the numbers
+ * touching the cells of the previous one) and searches it exhaustively
+ * Every layout of the group is a layout of this smaller problem, so no layout here means none in the group
+ */
+bool ExactSolver::isRefutedLocally(const Problem& group, int variable, int value) const
+{
+    std::vector<int> localOf(group.variableConstraints.size(), -1);
+    std::vector<char> isTaken(group.constraints.size(), 0);
+    std::vector<int> variables = {variable};
+    std::vector<int> taken;
+    std::vector<int> solution;
+    localOf[std::size_t(variable)] = 0;
+
+    Problem local;
+    std::size_t ringStart = 0;
+
+    for (int depth = 0; depth < LOCAL_REFUTATION_DEPTH; depth++) {
+
+        // Take the numbers touching the cells of the last ring, their cells form the next ring
+        std::size_t ringEnd = variables.size();
+        for (std::size_t i = ringStart; i < ringEnd; i++) {
+            for (int c : group.variableConstraints[std::size_t(variables[i])]) {
+                if (isTaken[std::size_t(c)])
+                    continue;
+                isTaken[std::size_t(c)] = 1;
+                taken.push_back(c);
+
+                for (int other : group.constraints[std::size_t(c)].variables) {
+                    if (localOf[std::size_t(other)] < 0) {
+                        localOf[std::size_t(other)] = int(variables.size());
+                        variables.push_back(other);
+                    }
+                }
+            }
+        }
+        ringStart = ringEnd;
+
+        if (variables.size() > LOCAL_REFUTATION_VARIABLES)
+            return false;
+
+        local.variableConstraints.assign(variables.size(), std::vector<int>());
+        local.constraints.clear();
+        for (int c : taken) {
+            Problem::Constraint constraint;
+            constraint.number = group.constraints[std::size_t(c)].number;
+            for (int other : group.constraints[std::size_t(c)].variables) {
+                local.variableConstraints[std::size_t(localOf[std::size_t(other)])].push_back(int(local.constraints.size()));
+                constraint.variables.push_back(localOf[std::size_t(other)]);
+            }
+            local.constraints.push_back(constraint);
+        }
+
+        local.reset();
+        if (!local.assign(0, value) || !local.search(solution, m_nodeLimit))
+            return local.nodes <= m_nodeLimit;
+
+        if (ringStart == variables.size())
+            return false;               // The whole group was taken
+    }
+
+    return false;
+}
+
+void ExactSolver::Problem::reset()
+{
+    values.assign(variableConstraints.size(), -1);
+    trail.clear();
+    for (Constraint& constraint : constraints) {
+        constraint.mines = 0;
+        constraint.unassigned = int(constraint.variables.size());
+    }
+    nodes = 0;
+}
+
+// Applies the assignment and every assignment it forces, a number whose mines are all found makes the rest safe,
+// a number with as many unassigned cells as missing mines makes them all mines
+bool ExactSolver::Problem::assign(int variable, int value)
+{
+    pending.clear();
+    pending.push_back({variable, value});
+
+    while (!pending.empty()) {
+        int v = pending.back().first;
+        int assigned = pending.back().second;
+        pending.pop_back();
+
+        if (values[std::size_t(v)] >= 0) {
+            if (values[std::size_t(v)] != assigned)
+                return false;
+            continue;
+        }
+
+        values[std::size_t(v)] = assigned;
+        trail.push_back(v);
+        nodes++;
+
+        for (int c : variableConstraints[std::size_t(v)]) {
+            constraints[std::size_t(c)].unassigned--;
+            constraints[std::size_t(c)].mines += assigned;
+        }
+
+        for (int c : variableConstraints[std::size_t(v)]) {
+            const Constraint& constraint = constraints[std::size_t(c)];
+            if (constraint.mines > constraint.number || constraint.mines + constraint.unassigned < constraint.number)
+                return false;
+
+            if (constraint.unassigned == 0)
+                continue;
+
+            int forced = constraint.mines == constraint.number ? 0 : constraint.mines + constraint.unassigned == constraint.number ? 1 : -1;
+            if (forced < 0)
+                continue;
+
+            for (int other : constraint.variables) {
+                if (values[std::size_t(other)] < 0)
+                    pending.push_back({other, forced});
+            }
+        }
+    }
+
+    return true;
+}
+
+void ExactSolver::Problem::undo(std::size_t trailSize)
+{
+    while (trail.size() > trailSize) {
+        int v = trail.back();
+        trail.pop_back();
+
+        for (int c : variableConstraints[std::size_t(v)]) {
+            constraints[std::size_t(c)].unassigned++;
+            constraints[std::size_t(c)].mines -= values[std::size_t(v)];
+        }
+        values[std::size_t(v)] = -1;
+    }
+}
+
+// Variables are tried in the order the group was collected, so each step stays next to the previous ones
+bool ExactSolver::Problem::search(std::vector<int>& solution, long long nodeLimit)
+{
+    std::size_t variable = 0;
+    std::vector<std::size_t> choices;       // Trail size before each decision
+    std::vector<int> decisions;             // Decided variable, and whether its second value was tried
+
+    // Iterative depth-first search, groups of a giant board are too deep for recursion
+    for (;;) {
+        while (variable < values.size() && values[variable] >= 0)
+            variable++;
+
+        if (variable == values.size()) {
+            solution = values;
+            return true;
+        }
+
+        if (nodes > nodeLimit)
+            return false;
+
+        // Decide the next variable, empty first
+        choices.push_back(trail.size());
+        decisions.push_back(int(variable) * 2);
+        if (assign(int(variable), 0))
+            continue;
+
+        // Backtrack to the last decision whose second value is left
+        for (;;) {
+            if (decisions.empty())
+                return false;
+
+            std::size_t trailSize = choices.back();
+            int decision = decisions.back();
+            undo(trailSize);
+
+            if (decision % 2 == 0) {
+                decisions.back() = decision + 1;
+                variable = std::size_t(decision / 2);
+                if (assign(int(variable), 1))
+                    break;
+                continue;
+            }
+
+            choices.pop_back();
+            decisions.pop_back();
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef EXACTSOLVER_H
+#define EXACTSOLVER_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "board.h"
+
+/*
+ * Finds every unrevealed cell whose content follows from the revealed numbers, used to label the corpus
+ *
+ * Unrevealed cells next to a revealed number are split into independent groups (cells linked through
+ * shared numbers); in each group a backtracking search with constraint propagation looks for mine layouts
+ * satisfying every number. A cell is provably safe (mine) if it is empty (mined) in every layout:
+ * one layout is found first, then for each cell a layout with the opposite value is searched for,
+ * every layout found rules out the values it shows for all cells at once
+ *
+ * Proving that no layout exists is the expensive part of a search, so the opposite value is first tried
+ * against the numbers near the cell only: if they already rule it out, so does the whole group
+ *
+ * Like the hint algorithm, the total amount of mines is not used
+ */
+class ExactSolver
+{
+public:
+    enum Label : std::uint8_t {
+        Unknown = 0,        // Revealed, or unrevealed and not decided by the numbers
+        Safe,
+        Mine
+    };
+
+    explicit ExactSolver(long long nodeLimit = 2000000) : m_nodeLimit{nodeLimit} {}
+
+    // Labels every cell of the board, returns false if a search went over the node limit
+    bool solve(const Board& board, std::vector<std::uint8_t>& labels);
+
+private:
+    // Mine layouts of some unrevealed cells (variables) under some revealed numbers (constraints)
+    struct Problem
+    {
+        struct Constraint
+        {
+            std::vector<int> variables;
+            int number;
+            int mines = 0;              // Variables assigned a mine
+            int unassigned = 0;         // Variables not assigned yet
+        };
+
+        std::vector<std::vector<int>> variableConstraints;
+        std::vector<Constraint> constraints;
+        std::vector<int> values;                        // -1 unassigned, 0 safe, 1 mine
+        std::vector<int> trail;                         // Assigned variables, in order, to undo assignments
+        std::vector<std::pair<int, int>> pending;       // Assignments forced by propagation, reused by assign()
+        long long nodes = 0;                            // Assignments made, to stop searches that take too long
+
+        void reset();                                   // Unassigns every variable
+        bool assign(int variable, int value);           // Assigns and propagates, returns false on a contradiction
+        void undo(std::size_t trailSize);
+        bool search(std::vector<int>& solution, long long nodeLimit);  // Completes the current assignment, false if impossible or over the limit
+    };
+
+    long long m_nodeLimit;
+
+    void solveGroup(Problem& group, std::vector<std::uint8_t>& seenValues, bool& isOverLimit) const;
+    bool isRefutedLocally(const Problem& group, int variable, int value) const;   // True if the numbers near the variable rule the value out
+};
+
+#endif // EXACTSOLVER_H
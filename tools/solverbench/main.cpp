@@ -0,0 +1,424 @@
+#include "corpus.h"
+#include "exactsolver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+
+/*
+ * Measures how much of what can be deduced the hint algorithm finds, whether it is ever wrong, and how long it takes
+ *
+ * generate: plays seeded games at 4 sizes and keeps one position from the middle of each game,
+ *           labelled by the ExactSolver with every provably safe and provably mined cell
+ *           Giant games are stopped after a few hundred clicks, each hint takes milliseconds on a million cells
+ * run:      calls Board::findHint() (what the hint button does) on every position of the corpus and compares
+ *           its marks with the labels; fails if any mark is wrong, if fewer cells are found than in the baseline,
+ *           or if the median, 99th percentile or maximum time of a tier grows beyond its tolerance
+ *
+ * Usage: solverbench generate CORPUS [--seed S]
+ *        solverbench run CORPUS [--baseline FILE] [--update-baseline] [--tolerance X]
+ *                        [--p50-tolerance X] [--p99-tolerance X] [--max-tolerance X] [--repeat N]
+ */
+
+namespace {
+
+struct Tier
+{
+    const char* name;
+    int rows;
+    int columns;
+    int mines;
+    int positions;
+    int clickLimit;     // Games are stopped after this many clicks and stored as replays, 0 plays them to the end
+};
+
+const Tier tiers[] = {
+    {"beginner",       9,    9,     10, 200,   0},
+    {"intermediate",  16,   16,     40, 200,   0},
+    {"expert",        16,   30,     99, 200,   0},
+    {"giant",       1000, 1000, 200000, 100, 400}
+};
+
+struct Options
+{
+    bool isGenerate = false;
+    std::string corpusPath;
+    std::string baselinePath;
+    bool updateBaseline = false;
+    double p50Tolerance = 1.3;      // Allowed growth of the median time
+    double p99Tolerance = 1.5;      // Allowed growth of the 99th percentile time
+    double maxTolerance = 2.0;      // Allowed growth of the slowest time, a single position is the noisiest
+    double slackMicroseconds = 20;  // Added to the allowed time, small times are mostly noise
+    int repeat = 3;                 // Each position is timed this many times, the fastest run counts
+    std::uint32_t seed = 1;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    if (argc < 3)
+        return false;
+
+    if (!std::strcmp(argv[1], "generate"))
+        options.isGenerate = true;
+    else if (std::strcmp(argv[1], "run"))
+        return false;
+    options.corpusPath = argv[2];
+
+    for (int i = 3; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--seed") && hasValue)
+            options.seed = std::uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--baseline") && hasValue)
+            options.baselinePath = argv[++i];
+        else if (!std::strcmp(argv[i], "--update-baseline"))
+            options.updateBaseline = true;
+        else if (!std::strcmp(argv[i], "--tolerance") && hasValue)
+            options.p50Tolerance = options.p99Tolerance = options.maxTolerance = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--p50-tolerance") && hasValue)
+            options.p50Tolerance = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--p99-tolerance") && hasValue)
+            options.p99Tolerance = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--max-tolerance") && hasValue)
+            options.maxTolerance = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--repeat") && hasValue)
+            options.repeat = std::max(1, std::atoi(argv[++i]));
+        else
+            return false;
+    }
+    return true;
+}
+
+// Lays out the mines of a game, replayed tiers use seedMines() so that their corpus entries can be replayed anywhere
+Board layOutBoard(const Tier& tier, const Topology& topology, std::uint32_t seed)
+{
+    Board board(topology);
+    if (tier.clickLimit > 0)
+        seedMines(board, tier.mines, seed);
+    else
+        board.generateMines(tier.mines, seed);
+    board.setMineNumbers();
+    return board;
+}
+
+/*
+ * Plays a game like the selfplay tool (random empty opening, hints, random guesses) and returns the clicks
+ * Stops after clickLimit clicks unless it is 0, returns an empty list if the board has no empty cell to open on
+ */
+std::vector<int> playGame(Board board, int clickLimit, std::mt19937& mt)
+{
+    const Topology& topology = board.topology();
+    std::vector<int> clicks;
+    std::vector<int> emptyCells;
+    for (int i = 0; i < topology.cellAmount(); i++) {
+        if (!board.isMine(i) && board.numberOfNeighbouringMines(i) == 0)
+            emptyCells.push_back(i);
+    }
+    if (emptyCells.empty())
+        return clicks;
+
+    std::uniform_int_distribution<> randomCell{0, topology.cellAmount() - 1};
+    std::vector<int> revealedCells;
+
+    clicks.push_back(emptyCells[std::size_t(randomCell(mt)) % emptyCells.size()]);
+    board.reveal(clicks.back(), revealedCells);
+
+    while (board.status() == GameStatus::Playing && (clickLimit == 0 || int(clicks.size()) < clickLimit)) {
+        int click = board.findHint();
+        if (click < 0) {
+            do {
+                click = randomCell(mt);
+            } while (board.isRevealed(click) || board.isMarkedUnsafe(click));
+        }
+        clicks.push_back(click);
+        board.reveal(click, revealedCells);
+    }
+
+    return clicks;
+}
+
+int generateCorpus(const Options& options)
+{
+    std::vector<CorpusPosition> positions;
+    ExactSolver solver;
+
+    for (const Tier& tier : tiers) {
+        Topology topology = Topology::rectangle(tier.rows, tier.columns);
+        std::mt19937 mt{options.seed * 7919u + std::uint32_t(tier.rows * 1000 + tier.columns)};
+        int kept = 0;
+        int skipped = 0;
+
+        for (std::uint32_t game = 0; kept < tier.positions; game++) {
+            std::uint32_t seed = options.seed + game * 2654435761u + std::uint32_t(tier.mines);
+            Board board = layOutBoard(tier, topology, seed);
+            std::vector<int> clicks = playGame(board, tier.clickLimit, mt);
+            if (clicks.size() < 2)
+                continue;
+
+            // Replay up to a random click before the last one, the game is still going there
+            std::size_t clickAmount = 1 + std::size_t(mt() % (clicks.size() - 1));
+            std::vector<int> revealedCells;
+            for (std::size_t i = 0; i < clickAmount; i++)
+                board.reveal(clicks[i], revealedCells);
+
+            CorpusPosition position;
+            position.tier = tier.name;
+            position.rowNumber = tier.rows;
+            position.columnNumber = tier.columns;
+            if (tier.clickLimit > 0) {
+                position.mineAmount = tier.mines;
+                position.mineSeed = seed;
+                position.clicks.assign(clicks.begin(), clicks.begin() + std::ptrdiff_t(clickAmount));
+            }
+            position.mines.resize(std::size_t(topology.cellAmount()));
+            position.revealed.resize(std::size_t(topology.cellAmount()));
+            for (int i = 0; i < topology.cellAmount(); i++) {
+                position.mines[std::size_t(i)] = board.isMine(i);
+                position.revealed[std::size_t(i)] = board.isRevealed(i);
+            }
+
+            // Positions the exact solver can't finish would have incomplete labels
+            if (!solver.solve(board, position.labels)) {
+                skipped++;
+                continue;
+            }
+            positions.push_back(position);
+            kept++;
+        }
+
+        std::printf("%-12s %d positions (%d skipped)\n", tier.name, tier.positions, skipped);
+    }
+
+    if (!saveCorpus(options.corpusPath, positions)) {
+        std::fprintf(stderr, "can't write %s\n", options.corpusPath.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+struct TierResult
+{
+    int positions = 0;
+    long long possible = 0;             // Provably safe or mined cells
+    long long found = 0;                // Of these, marked by the hint algorithm
+    long long falsePositives = 0;       // Marks that aren't provable
+    std::vector<double> times;          // Microseconds per position
+
+    double percentile(double fraction) const
+    {
+        if (times.empty())
+            return 0;
+        std::vector<double> sorted = times;
+        std::sort(sorted.begin(), sorted.end());
+        std::size_t rank = std::size_t(std::ceil(fraction * double(sorted.size())));
+        return sorted[std::min(sorted.size() - 1, rank ? rank - 1 : 0)];
+    }
+};
+
+// Baseline of a tier: positions, possible, found, p50, p99 and max time
+struct Baseline
+{
+    int positions = 0;
+    long long possible = 0;
+    long long found = 0;
+    double p50 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+bool loadBaseline(const std::string& path, std::map<std::string, Baseline>& baselines)
+{
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line) || line != "minesweeper-solver-baseline " + std::to_string(CORPUS_VERSION))
+        return false;
+
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream stream(line);
+        std::string tier;
+        Baseline baseline;
+        if (stream >> tier >> baseline.positions >> baseline.possible >> baseline.found >> baseline.p50 >> baseline.p99 >> baseline.max)
+            baselines[tier] = baseline;
+    }
+    return true;
+}
+
+// Lines starting with "# note:" record changes of the hint algorithm that moved the baseline, they are kept
+bool saveBaseline(const std::string& path, const std::map<std::string, TierResult>& results)
+{
+    std::vector<std::string> notes;
+    std::ifstream previous(path);
+    std::string line;
+    while (std::getline(previous, line)) {
+        if (line.compare(0, 7, "# note:") == 0)
+            notes.push_back(line);
+    }
+    previous.close();
+
+    std::ofstream file(path);
+    file << "minesweeper-solver-baseline " << CORPUS_VERSION << "\n";
+    file << "# Times are microseconds on the machine that wrote this file, regenerate with --update-baseline\n";
+    for (const std::string& note : notes)
+        file << note << "\n";
+    file << "# tier positions possible found p50 p99 max\n";
+
+    for (const Tier& tier : tiers) {
+        auto result = results.find(tier.name);
+        if (result == results.end())
+            continue;
+        const TierResult& r = result->second;
+        char line[256];
+        std::snprintf(line, sizeof(line), "%s %d %lld %lld %.1f %.1f %.1f\n", tier.name, r.positions, r.possible, r.found,
+                      r.percentile(0.5), r.percentile(0.99), r.percentile(1.0));
+        file << line;
+    }
+    return bool(file);
+}
+
+int runCorpus(const Options& options)
+{
+    std::vector<CorpusPosition> positions;
+    std::string error;
+    if (!loadCorpus(options.corpusPath, positions, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    std::map<std::string, TierResult> results;
+    DeductionCache& cache = DeductionCache::shared();
+
+    for (const CorpusPosition& position : positions) {
+        TierResult& result = results[position.tier];
+        Board prepared = position.makeBoard();
+
+        // Every run starts from the same unmarked board and an empty cache, so the order of positions doesn't matter
+        double fastest = 0;
+        Board board = prepared;
+        for (int run = 0; run < options.repeat; run++) {
+            board = prepared;
+            cache.clear();
+
+            auto start = std::chrono::steady_clock::now();
+            board.findHint();
+            double time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            fastest = run == 0 ? time : std::min(fastest, time);
+        }
+
+        result.positions++;
+        result.times.push_back(fastest);
+
+        for (int i = 0; i < position.rowNumber * position.columnNumber; i++) {
+            std::uint8_t label = position.labels[std::size_t(i)];
+            if (label != ExactSolver::Unknown)
+                result.possible++;
+            if (board.isRevealed(i))
+                continue;
+
+            if (board.isMarkedSafe(i)) {
+                if (label == ExactSolver::Safe)
+                    result.found++;
+                else
+                    result.falsePositives++;
+            }
+            if (board.isMarkedUnsafe(i)) {
+                if (label == ExactSolver::Mine)
+                    result.found++;
+                else
+                    result.falsePositives++;
+            }
+        }
+    }
+
+    std::map<std::string, Baseline> baselines;
+    bool hasBaseline = !options.baselinePath.empty() && !options.updateBaseline && loadBaseline(options.baselinePath, baselines);
+    if (!options.baselinePath.empty() && !options.updateBaseline && !hasBaseline) {
+        std::fprintf(stderr, "can't read baseline %s\n", options.baselinePath.c_str());
+        return 1;
+    }
+
+    bool isPassed = true;
+    std::printf("%-12s %9s %9s %9s %7s %10s %10s %10s\n", "tier", "positions", "possible", "found", "wrong", "p50 us", "p99 us", "max us");
+
+    for (const Tier& tier : tiers) {
+        auto found = results.find(tier.name);
+        if (found == results.end())
+            continue;
+        const TierResult& r = found->second;
+
+        std::printf("%-12s %9d %9lld %8.1f%% %7lld %10.1f %10.1f %10.1f\n", tier.name, r.positions, r.possible,
+                    r.possible ? 100.0 * double(r.found) / double(r.possible) : 100.0, r.falsePositives,
+                    r.percentile(0.5), r.percentile(0.99), r.percentile(1.0));
+
+        if (r.falsePositives > 0) {
+            std::printf("  FAIL: %lld marks are not provable\n", r.falsePositives);
+            isPassed = false;
+        }
+
+        if (!hasBaseline)
+            continue;
+
+        auto baseline = baselines.find(tier.name);
+        if (baseline == baselines.end() || baseline->second.positions != r.positions || baseline->second.possible != r.possible) {
+            std::printf("  FAIL: the baseline doesn't match this corpus\n");
+            isPassed = false;
+            continue;
+        }
+
+        if (r.found < baseline->second.found) {
+            std::printf("  FAIL: %lld cells found, baseline %lld\n", r.found, baseline->second.found);
+            isPassed = false;
+        }
+
+        const struct {
+            const char* name;
+            double time;
+            double baselineTime;
+            double tolerance;
+        } gates[] = {
+            {"p50", r.percentile(0.5), baseline->second.p50, options.p50Tolerance},
+            {"p99", r.percentile(0.99), baseline->second.p99, options.p99Tolerance},
+            {"max", r.percentile(1.0), baseline->second.max, options.maxTolerance}
+        };
+        for (const auto& gate : gates) {
+            double allowed = gate.baselineTime * gate.tolerance + options.slackMicroseconds;
+            if (gate.time > allowed) {
+                std::printf("  FAIL: %s %.1f us, allowed %.1f us (baseline %.1f us)\n", gate.name, gate.time, allowed, gate.baselineTime);
+                isPassed = false;
+            }
+        }
+    }
+
+    if (options.updateBaseline) {
+        if (options.baselinePath.empty() || !saveBaseline(options.baselinePath, results)) {
+            std::fprintf(stderr, "can't write the baseline\n");
+            return 1;
+        }
+        std::printf("baseline written to %s\n", options.baselinePath.c_str());
+    }
+
+    std::printf("%s\n", isPassed ? "PASS" : "FAIL");
+    return isPassed ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: solverbench generate CORPUS [--seed S]\n"
+                             "       solverbench run CORPUS [--baseline FILE] [--update-baseline] [--tolerance X]\n"
+                             "                       [--p50-tolerance X] [--p99-tolerance X] [--max-tolerance X] [--repeat N]\n");
+        return 2;
+    }
+
+    return options.isGenerate ? generateCorpus(options) : runCorpus(options);
+}
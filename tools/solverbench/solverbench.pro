@@ -0,0 +1,18 @@
+# Benchmarks the quality and speed of the hint algorithm on a fixed corpus of positions
+# Run from this folder: solverbench run corpus/v1.txt --baseline baseline.txt
+
+TEMPLATE = app
+TARGET = solverbench
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    corpus.cpp \
+    exactsolver.cpp \
+    main.cpp
+
+HEADERS += \
+    corpus.h \
+    exactsolver.h
@@ -0,0 +1,129 @@
+#include "topology.h"
+
+/*
+ * This file provides implementations for the member functions of Topology class declared in topology.h
+ */
+
+// Classic rectangular board, every grid position is a cell
+Topology Topology::rectangle(int rowNumber, int columnNumber)
+{
+    return Topology(rowNumber, columnNumber, std::vector<bool>(rowNumber * columnNumber, true), false);
+}
+
+// Rectangular board whose left/right and top/bottom edges are glued together
+Topology Topology::torus(int rowNumber, int columnNumber)
+{
+    return Topology(rowNumber, columnNumber, std::vector<bool>(rowNumber * columnNumber, true), true);
+}
+
+// Board with holes, mask has one entry per grid position in row-major order
+Topology Topology::masked(int rowNumber, int columnNumber, const std::vector<bool>& mask, bool wrapAround)
+{
+    return Topology(rowNumber, columnNumber, mask, wrapAround);
+}
+
+/*
+ * Builds a board from a drawing such as
+ *     ".##."
+ *     "####"
+ *     ".##."
+ * Shorter rows are padded with holes so the grid is as wide as the longest row
+ */
+Topology Topology::fromPattern(const std::vector<std::string>& pattern, bool wrapAround)
+{
+    int rowNumber = int(pattern.size());
+    int columnNumber = 0;
+    for (const std::string& row : pattern) {
+        if (int(row.size()) > columnNumber)
+            columnNumber = int(row.size());
+    }
+
+    std::vector<bool> mask(rowNumber * columnNumber, false);
+    for (int i = 0; i < rowNumber; i++) {
+        for (int j = 0; j < int(pattern[i].size()); j++) {
+            mask[i * columnNumber + j] = (pattern[i][j] == '#');
+        }
+    }
+
+    return Topology(rowNumber, columnNumber, mask, wrapAround);
+}
+
+/*
+ * Precomputes the adjacency of every cell
+ * Cells are visited in index order, so each neighbour list is appended right after the previous one
+ * and the end of the list is recorded as the start offset of the next cell
+ */
+Topology::Topology(int rowNumber, int columnNumber, const std::vector<bool>& mask, bool wrapAround)
+    : m_rowNumber{rowNumber}
+    , m_columnNumber{columnNumber}
+    , m_isWrapped{wrapAround}
+{
+    int cellAmount = rowNumber * columnNumber;
+
+    m_isActive.assign(cellAmount, 0);
+    for (int i = 0; i < cellAmount; i++) {
+        if (mask[i]) {
+            m_isActive[i] = 1;
+            m_activeCellAmount++;
+        }
+    }
+
+    m_offsets.reserve(cellAmount + 1);
+    m_neighbours.reserve(std::size_t(m_activeCellAmount) * 8);
+    m_offsets.push_back(0);
+
+    for (int i = 0; i < rowNumber; i++) {
+        for (int j = 0; j < columnNumber; j++) {
+
+            int index = i * columnNumber + j;
+            std::size_t listStart = m_neighbours.size();
+
+            // Holes don't have any neighbours
+            if (m_isActive[index]) {
+                for (int rowOffset = -1; rowOffset <= 1; rowOffset++) {
+                    for (int columnOffset = -1; columnOffset <= 1; columnOffset++) {
+
+                        if (rowOffset == 0 && columnOffset == 0)
+                            continue;
+
+                        int row = i + rowOffset;
+                        int column = j + columnOffset;
+
+                        // On a torus, positions outside the grid wrap to the opposite edge
+                        if (wrapAround) {
+                            row = (row + rowNumber) % rowNumber;
+                            column = (column + columnNumber) % columnNumber;
+                        }
+                        else if (row < 0 || row >= rowNumber || column < 0 || column >= columnNumber) {
+                            continue;
+                        }
+
+                        std::uint32_t neighbourIndex = std::uint32_t(row * columnNumber + column);
+
+                        // Skip holes and, on very narrow tori, the cell itself or a neighbour reached twice
+                        if (!m_isActive[neighbourIndex] || neighbourIndex == std::uint32_t(index))
+                            continue;
+
+                        bool isDuplicate = false;
+                        for (std::size_t k = listStart; k < m_neighbours.size(); k++) {
+                            if (m_neighbours[k] == neighbourIndex)
+                                isDuplicate = true;
+                        }
+                        if (!isDuplicate)
+                            m_neighbours.push_back(neighbourIndex);
+                    }
+                }
+            }
+
+            m_offsets.push_back(std::uint32_t(m_neighbours.size()));
+        }
+    }
+
+    m_neighbours.shrink_to_fit();
+}
+
+// Returns the number of bytes held by the adjacency arrays
+std::size_t Topology::adjacencyBytes() const
+{
+    return m_offsets.size() * sizeof(std::uint32_t) + m_neighbours.size() * sizeof(std::uint32_t);
+}
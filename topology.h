@@ -0,0 +1,61 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * This class describes the shape of a board and which cells are adjacent to each other
+ * Cells are addressed by a single index (row * columnNumber + column) on a rows x columns grid
+ * Cells outside the shape (holes of a mask) are inactive, they have no neighbours and are nobody's neighbour
+ *
+ * Adjacency is computed once on construction and stored in compressed sparse row (CSR) form:
+ * the neighbours of cell i are m_neighbours[m_offsets[i]] ... m_neighbours[m_offsets[i + 1] - 1]
+ * Reveal, mine counting and the hint algorithm iterate over this flat array instead of pointers in each cell
+ */
+class Topology
+{
+public:
+    Topology() = default;
+
+    // Factory functions for the supported board variants
+    static Topology rectangle(int rowNumber, int columnNumber);                    // Classic board, cells on the edges have fewer neighbours
+    static Topology torus(int rowNumber, int columnNumber);                        // Edges wrap around, every cell has 8 neighbours
+    static Topology masked(int rowNumber, int columnNumber,
+                           const std::vector<bool>& mask, bool wrapAround = false); // Only cells whose mask entry is true are part of the board
+    static Topology fromPattern(const std::vector<std::string>& pattern,
+                                bool wrapAround = false);                          // Custom shape drawn with '#' (cell) and '.' (hole), one string per row
+
+    int rowNumber() const { return m_rowNumber; }
+    int columnNumber() const { return m_columnNumber; }
+    int cellAmount() const { return m_rowNumber * m_columnNumber; }               // Number of grid positions, including holes
+    int activeCellAmount() const { return m_activeCellAmount; }                   // Number of cells that are part of the board
+    bool isWrapped() const { return m_isWrapped; }
+
+    bool isActive(int index) const { return m_isActive[index] != 0; }
+    int indexOf(int row, int column) const { return row * m_columnNumber + column; }
+    int rowOf(int index) const { return index / m_columnNumber; }
+    int columnOf(int index) const { return index % m_columnNumber; }
+
+    // Neighbour access, used as: for (const std::uint32_t* n = neighboursBegin(i); n != neighboursEnd(i); ++n)
+    int neighbourAmount(int index) const { return int(m_offsets[index + 1] - m_offsets[index]); }
+    const std::uint32_t* neighboursBegin(int index) const { return m_neighbours.data() + m_offsets[index]; }
+    const std::uint32_t* neighboursEnd(int index) const { return m_neighbours.data() + m_offsets[index + 1]; }
+
+    std::size_t adjacencyBytes() const;                                           // Memory used by the CSR arrays
+
+private:
+    Topology(int rowNumber, int columnNumber, const std::vector<bool>& mask, bool wrapAround);
+
+    int m_rowNumber = 0;
+    int m_columnNumber = 0;
+    int m_activeCellAmount = 0;
+    bool m_isWrapped = false;
+
+    std::vector<std::uint8_t> m_isActive;       // 1 if the grid position is part of the board
+    std::vector<std::uint32_t> m_offsets;       // cellAmount() + 1 entries, start of each cell's neighbour list
+    std::vector<std::uint32_t> m_neighbours;    // Neighbour indices of all cells, stored back to back
+};
+
+#endif // TOPOLOGY_H
@@ -1,4 +1,11 @@
 #include "widget.h"
+#include "boardrenderer.h"
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QShortcut>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
 #include <random>
 
 // This file provides implementations for the member functions of Widget class declared in widget.h
@@ -7,18 +14,72 @@
 // When constructed, widget objects creates the window and layouts for the UI element
 Widget::Widget(QWidget *parent)
     : QWidget(parent)
+    , m_topology{Topology::rectangle(ROW_NUMBER, COLUMN_NUMBER)}
 {
     setWindowTitle("Minesweeper");                          // Set game title
 
     mainLayout = new QGridLayout(this);                     // mainLayout is container of all other UI elements
 
+    // Revealed cells that don't fit in one slice are shown on the following event loop turns
+    m_revealTimer = new QTimer(this);
+    QObject::connect(m_revealTimer, &QTimer::timeout, this, &Widget::applyPendingReveals);
+
+    // The search for the best guess can take the whole time budget of the solver, it doesn't block the event loop
+    m_guessWatcher = new QFutureWatcher<EndgameResult>(this);
+    QObject::connect(m_guessWatcher, &QFutureWatcherBase::finished, this, &Widget::showGuess);
+    m_endgameSolver.setCancelFlag(&m_isGuessCancelled);
+
+    // Snapshots of the board, drawn from the game state instead of grabbing the widget
+    QShortcut* snapshotShortcut = new QShortcut(QKeySequence::Save, this);
+    QObject::connect(snapshotShortcut, &QShortcut::activated, this, &Widget::saveSnapshot);
+    QShortcut* tileSnapshotShortcut = new QShortcut(QKeySequence("Ctrl+Shift+S"), this);
+    QObject::connect(tileSnapshotShortcut, &QShortcut::activated, this, &Widget::saveTileSnapshot);
 
     Widget::setInitialState();                              // Starts the game by setting initial state of UI elements and game logic
 
 
 }
 
-Widget::~Widget() {}
+Widget::~Widget() {
+    // The search reads m_topology and m_guessState
+    cancelGuess();
+    qDeleteAll(m_cells);
+    delete m_board;
+}
+
+/*
+ * Progressive reveal shows large cascades a few milliseconds at a time instead of blocking inside the mouse event
+ * The wave-front animation additionally limits each step to a fixed number of cells, since the board reveals
+ * cells in breadth-first order this looks like the opening spreading out from the clicked cell
+ * A BoardView draws any number of cells in the same time, so on large boards only the wave animation changes anything
+ */
+void Widget::setProgressiveReveal(bool isProgressive, bool isWaveAnimation)
+{
+    m_isProgressiveReveal = isProgressive;
+    m_isWaveAnimation = isProgressive && isWaveAnimation;
+}
+
+// Replaces the shape of the board and starts a new game on it
+void Widget::setTopology(const Topology& topology)
+{
+    cancelGuess();
+    m_topology = topology;
+    restart();
+}
+
+// Keeps the shape of the board and starts a new game with the given number of mines
+void Widget::setMineAmount(int mineAmount)
+{
+    m_mineAmount = mineAmount;
+    restart();
+}
+
+// The search grows quickly with the region, a larger region may use the whole time budget of the solver
+void Widget::setEndgameCells(int cellAmount)
+{
+    m_guessWatcher->waitForFinished();
+    m_endgameSolver.setMaxUnknownCells(cellAmount);
+}
 
 int Widget::setCellSize(int columnNumber, int rowNumber) {
 
@@ -37,116 +98,82 @@ int Widget::setCellSize(int columnNumber, int rowNumber) {
 
 
 /*  This function is responsible for setting game-logic in three steps
- *  First, creates the cells and stores them in the m_cellArray
- *  Second, sets neighbourhood relationship for each adjacent cell
+ *  First, creates the board for the current topology, neighbourhood relationships are precomputed by the topology
+ *  Second, creates the UI of each cell of the board and stores them in m_cells,
+ *  or a single BoardView for boards too large for a button per cell
  *  Finally assigns each cell either a mine or a number indicating amount of adjacent mines.
  */
 void Widget::initializeCells()
 {
+    m_board = new Board(m_topology);
+
+    // m_cells stays empty, a board of millions of cells would otherwise get as many null pointers
+    if (m_topology.activeCellAmount() > BOARD_VIEW_CELLS) {
+        m_boardView = new BoardView(m_board, this);
+        m_cellGrid->addWidget(m_boardView, 1, 2);
+
+        // Same signals as the cells, reveals are displayed by the widget
+        QObject::connect(m_boardView, &BoardView::cellsRevealed, this, &Widget::showRevealedCells);
+        QObject::connect(m_boardView, &BoardView::lostGame, this, &Widget::setLoseScreen);
+        QObject::connect(m_boardView, &BoardView::wonGame, this, &Widget::setWinScreen);
+
+        generateMines(m_mineAmount);
+        setMineNumbers();
+        return;
+    }
+
+    m_cells.assign(m_topology.cellAmount(), nullptr);
 
-    for(int i = 0; i < ROW_NUMBER; i++)
+    // Size of each cell is determined based on number of rows and columns
+    int cellSize = setCellSize(m_topology.columnNumber(), m_topology.rowNumber());
+
+    for(int i = 0; i < m_topology.rowNumber(); i++)
     {
-        for (int j = 0; j < COLUMN_NUMBER; j++)
+        for (int j = 0; j < m_topology.columnNumber(); j++)
         {
-            // Each entry in m_cellArray is a pointer to a Cell that holds.
-            m_cellArray[i][j] = new Cell(i, j, this);
+            int index = m_topology.indexOf(i, j);
+
+            // Holes of a masked board are left empty on the layout
+            if (!m_topology.isActive(index))
+                continue;
+
+            // Each entry in m_cells is a pointer to a Cell that holds the UI elements of the cell.
+            Cell* cell = new Cell(index, m_board, this);
+            m_cells[index] = cell;
 
 
             // Create a label for each each cell to be used after the cell is revealed
             QLabel* cellLabel = new QLabel(this);
             cellLabel->setAlignment(Qt::AlignCenter);
             cellLabel->setVisible(false);                       // Labels are invisible until the button of the cell is clicked
-            m_cellArray[i][j]->m_cellLabel = cellLabel;         // Each label is stored as a member variable of the corresponding cell
+            cell->m_cellLabel = cellLabel;                      // Each label is stored as a member variable of the corresponding cell
             m_cellGrid->addWidget(cellLabel,i + 1, j + 2);      // Place the invisible label on the layout
 
-            // Size of each cell is determined based on number of rows and columns
-            int cellSize = setCellSize(COLUMN_NUMBER, ROW_NUMBER);
-
             // Create a button for each cell. When clicked these buttons reveal the label of cells that were previously invisible
             CellButton* cellButton = new CellButton(this);
             cellButton->setIcon(QIcon(":/image/empty.png"));
             cellButton->setFixedSize(cellSize, cellSize);
             cellButton->setIconSize(QSize(cellSize, cellSize));
-            m_cellArray[i][j]->m_cellButton = cellButton;         // Each button is stored as a member variable of the corresponding cell
+            cell->m_cellButton = cellButton;                      // Each button is stored as a member variable of the corresponding cell
             m_cellGrid->addWidget(cellButton,i + 1, j + 2);       // Display the button on the layout
 
 
             // Connect the functionalities of left and right button clicks with related slots
             // When a button is left clicked, it reveals its label
-            QObject::connect(cellButton, &CellButton::onLeftClick, m_cellArray[i][j], &Cell::revealCell);
+            QObject::connect(cellButton, &CellButton::onLeftClick, cell, &Cell::revealCell);
             // When a button is right clicked, it flags the cell without revealing the label
-            QObject::connect(cellButton, &CellButton::onRightClick, m_cellArray[i][j], &Cell::flagCell);
-
-            // Connect the win and lose conditions signals with functions that sets win and lose screens
-            QObject::connect(m_cellArray[i][j], &Cell::lostGame, this, &Widget::setLoseScreen);
-            QObject::connect(m_cellArray[i][j], &Cell::wonGame, this, &Widget::setWinScreen);
-
-
-
-        }
-    }
-
-    // Set neighbours of cells by traversing over each cell.
-    // Some cells have less neighbours as they are placed on the boundaries
-    for(int i = 0; i < ROW_NUMBER; i++) {
-
-        for(int j = 0; j < COLUMN_NUMBER; j++) {
-
-            Cell* currentCell = m_cellArray[i][j];
-
-            // If the current cell is not leftmost cell, it has left neighbours
-            if(i > 0) {
-
-                currentCell->addNeighbour(m_cellArray[i-1][j]);           // left neighbour
-
-                // Current cell is not at the bottom so it has down neighbour
-                if (j > 0) {
-                    currentCell->addNeighbour(m_cellArray[i-1][j-1]);     //down_left neighbour
-
-                }
-                // Current cell is not at the top so it has up neighbour
-                if (j < COLUMN_NUMBER - 1) {
-                    currentCell->addNeighbour(m_cellArray[i-1][j+1]);     //up_left neighbour
-
-                }
-
-            }
-
-            // Current cell is not rightmost, so it has right neighbours
-            if(i < ROW_NUMBER - 1) {
-
-
-                currentCell->addNeighbour(m_cellArray[i+1][j]);             // right neighbour
-
-                // Current cell is not at the bottom so it has down neighbour
-                if (j > 0) {
-
-                    currentCell->addNeighbour(m_cellArray[i+1][j-1]);       //down_right neighbour
-
-                }
-                // Current cell is not at the top so it has up neighbour
-                if (j < COLUMN_NUMBER - 1) {
+            QObject::connect(cellButton, &CellButton::onRightClick, cell, &Cell::flagCell);
 
-                    currentCell->addNeighbour(m_cellArray[i+1][j+1]);       //up_right neighbour
-                }
+            // Every cell opened by a reveal, including the cascade over empty cells, is displayed by the widget
+            QObject::connect(cell, &Cell::cellsRevealed, this, &Widget::showRevealedCells);
 
-            }
-
-            // Current cell is not at the bottom, so it has down neighbours
-            if (j > 0) {
-
-                currentCell->addNeighbour(m_cellArray[i][j-1]);             // down neighbour
-            }
-
-            // Current cell is not at the top, so it has up neighbours
-            if (j < COLUMN_NUMBER - 1) {
-
-                currentCell->addNeighbour(m_cellArray[i][j+1]);             // up neighbour
-            }
+            // Connect the win and lose conditions signals with functions that sets win and lose screens
+            QObject::connect(cell, &Cell::lostGame, this, &Widget::setLoseScreen);
+            QObject::connect(cell, &Cell::wonGame, this, &Widget::setWinScreen);
         }
     }
 
-    generateMines(MINE_AMOUNT);         // Assign mines to cells
+    generateMines(m_mineAmount);        // Assign mines to cells
     setMineNumbers();                   // Calculate the number associated with each non-mined cell
 
 
@@ -155,98 +182,114 @@ void Widget::initializeCells()
 
 
 /*
- * Distribute the mines over cells randomly using a mersene-twister random number generation
+ * Distribute the mines over cells randomly, the board uses a mersenne-twister random number generator
+ * seeded from std::random_device so each game has a different distribution
  * mineAmount argument determines the total number of mines that should be distributed over cells
  */
 void Widget::generateMines(int mineAmount)
 {
-    // Set the random number generator and the seed.
-    std::mt19937 mt{std::random_device{}()};
-    // Generated numbers should be limited to interval of (0, numberOfCells)
-    std::uniform_int_distribution<> generateMineIndex{0, ROW_NUMBER * COLUMN_NUMBER - 1};
-
-
-    int remainingMineAmount = mineAmount;
-
-    // Randomly distribute mines until there is no mine left to place.
-    while(remainingMineAmount > 0) {
+    m_board->generateMines(mineAmount, std::random_device{}());
+}
 
-        // Transform 1D number generated by random number generator to a 2D tuple of (rowIndex, columnIndex),
-        // this  tuple is then used to locate the cell that mine should be placed to
-        int mineIndex = generateMineIndex(mt);
-        int rowIndex = mineIndex / COLUMN_NUMBER;
-        int columnIndex = mineIndex % COLUMN_NUMBER;
+/*
+ * Reveals all unrevealed cells
+ * This function is called when game ends with a win
+ * Buttons stop responding since the board ignores actions once the game is over
+ */
+void Widget::revealAllCells() {
 
-        // If that cell already has a mine, get another random cell
-        if(m_cellArray[rowIndex][columnIndex]->m_isMine) {
-            continue;
-        }
+    std::vector<int> revealedCells;
+    m_board->revealAllCells(revealedCells);
+    showRevealedCells(revealedCells);
+}
 
-        // Place the mine to the cell
-        m_cellArray[rowIndex][columnIndex]->m_isMine = true;
 
-        remainingMineAmount--;
-    }
+/*
+ * Reveals all unrevealed mines
+ * This function is called when game ends with a lose
+ * Buttons stop responding since the board ignores actions once the game is over
+ */
+void Widget::revealAllMines() {
 
+    std::vector<int> revealedCells;
+    m_board->revealAllMines(revealedCells);
+    showRevealedCells(revealedCells);
 }
 
 /*
- * Reveals all unrevealed cells by iterating over each cell
- * This function is called when game ends with a win
+ * Displays the cells opened by a reveal and updates the score
+ * In progressive mode the cells are queued, the first slice is shown right away and the rest on the next event loop turns
  */
-void Widget::revealAllCells() {
+void Widget::showRevealedCells(const std::vector<int>& revealedCells)
+{
+    m_scoreLabel->setText("Score: " + QString::number(m_board->revealedCellAmount()));
 
-    // Iterate over each cell
-    for(int i = 0; i < ROW_NUMBER; i++)
-    {
-        for (int j = 0; j < COLUMN_NUMBER; j++)
-        {
-            // get the cell at the current location
-            Cell* currentCell = m_cellArray[i][j];
+    // The view draws from the board, a frame costs the same however many cells are revealed
+    // The wave animation holds the cells back and shows them from the pending queue like the cell buttons
+    if (m_boardView && !m_isWaveAnimation) {
+        m_boardView->updateCells(revealedCells);
+        return;
+    }
+    if (m_boardView) {
+        m_boardView->holdCells(revealedCells);
+    }
 
-            // Deactivate the functionalities of the buttons of revealed cells
-            QObject::disconnect(currentCell->m_cellButton, &CellButton::onLeftClick, m_cellArray[i][j], &Cell::revealCell);
-            QObject::disconnect(currentCell->m_cellButton, &CellButton::onRightClick, m_cellArray[i][j], &Cell::flagCell);
+    if (!m_isProgressiveReveal) {
+        for (int index : revealedCells) {
+            m_cells[index]->showRevealed();
+        }
+        return;
+    }
 
-            // Reveal unrevealed cells by making their button invisible and their label visible
-            if(!currentCell->m_isRevealed) {
+    m_pendingReveals.insert(m_pendingReveals.end(), revealedCells.begin(), revealedCells.end());
 
-                currentCell->m_isRevealed = true;
+    // Small reveals complete inside the current event, the wave animation always starts on the timer
+    if (!m_isWaveAnimation) {
+        applyPendingReveals();
+    }
 
-                currentCell->m_cellButton->setVisible(false);
-                currentCell-> m_cellLabel->setVisible(true);
-            }
-        }
+    if (m_pendingRevealPosition < m_pendingReveals.size() && !m_revealTimer->isActive()) {
+        m_revealTimer->start(m_isWaveAnimation ? REVEAL_WAVE_FRAME_MS : 0);
     }
 }
 
-
 /*
- * Reveals all unrevealed mines by iterating over each cell
- * This function is called when game ends with a lose
+ * Shows pending revealed cells until the slice time is used up (or a wave step is complete),
+ * the timer is stopped once every pending cell is shown
  */
-void Widget::revealAllMines() {
+void Widget::applyPendingReveals()
+{
+    QElapsedTimer sliceTimer;
+    sliceTimer.start();
+
+    std::size_t stepEnd = m_pendingReveals.size();
+    std::size_t stepCells = std::max<std::size_t>(REVEAL_WAVE_CELLS_PER_FRAME,
+                                                  (m_pendingReveals.size() + REVEAL_WAVE_MAX_FRAMES - 1) / REVEAL_WAVE_MAX_FRAMES);
+    if (m_isWaveAnimation && m_pendingRevealPosition + stepCells < stepEnd) {
+        stepEnd = m_pendingRevealPosition + stepCells;
+    }
 
-    // Iterate over each cell
-    for(int i = 0; i < ROW_NUMBER; i++)
-    {
-        for (int j = 0; j < COLUMN_NUMBER; j++)
-        {
-            // get the cell at the current location
-            Cell* currentCell = m_cellArray[i][j];
+    // The view only marks the cells of the step, they are drawn on the next paint
+    if (m_boardView) {
+        m_boardView->updateCells(std::vector<int>(m_pendingReveals.begin() + std::ptrdiff_t(m_pendingRevealPosition),
+                                                  m_pendingReveals.begin() + std::ptrdiff_t(stepEnd)));
+        m_pendingRevealPosition = stepEnd;
+    }
 
-            // Deactivate the functionalities of the buttons of revealed cells
-            QObject::disconnect(currentCell->m_cellButton, &CellButton::onLeftClick, m_cellArray[i][j], &Cell::revealCell);
-            QObject::disconnect(currentCell->m_cellButton, &CellButton::onRightClick, m_cellArray[i][j], &Cell::flagCell);
+    while (m_pendingRevealPosition < stepEnd) {
 
-            // Reveal unrevealed mines by making their button invisible and their label visible
-            if(!currentCell->m_isRevealed && currentCell->m_isMine) {
+        m_cells[m_pendingReveals[m_pendingRevealPosition++]]->showRevealed();
 
-                currentCell->m_isRevealed = true;
-                currentCell->m_cellButton->setVisible(false);
-                currentCell-> m_cellLabel->setVisible(true);
-            }
-        }
+        // Checking the clock is cheap compared to showing a cell, but there is no need to do it for every cell
+        if ((m_pendingRevealPosition & 63) == 0 && sliceTimer.elapsed() >= REVEAL_SLICE_MS)
+            break;
+    }
+
+    // Everything is shown, release the queue
+    if (m_pendingRevealPosition == m_pendingReveals.size()) {
+        m_pendingReveals.clear();
+        m_pendingRevealPosition = 0;
+        m_revealTimer->stop();
     }
 }
 
@@ -257,12 +300,13 @@ void Widget::revealAllMines() {
  */
 void Widget::setMineNumbers()
 {
-    // Iterate over each cell
-    for(int i = 0; i < ROW_NUMBER; i++) {
-        for(int j = 0; j < COLUMN_NUMBER; j++) {
-            // Assigning numbers is done via the call to a member function of Cell class
-            m_cellArray[i][j]->setNumberOfNeighbouringMines();
-        }
+    // Numbers are counted by the board over the precomputed neighbourhood of each cell
+    m_board->setMineNumbers();
+
+    // Displaying them is done via the call to a member function of Cell class
+    for (Cell* cell : m_cells) {
+        if (cell)
+            cell->setCellLabel();
     }
 }
 
@@ -291,7 +335,6 @@ void Widget::setInitialState()
     m_scoreLabel = new QLabel(this);
     m_scoreLabel->setText("Score : 0");
     mainLayout->addWidget(m_scoreLabel,0, 0, 1, 1);             // Score is displayed on the top left of the layout
-    Cell::s_scoreLabel = m_scoreLabel;                          // Store the label in Cell class as a static variable
 
 
     // Restart button is used to allow player to start a new game with a different distribution of mines.
@@ -315,84 +358,143 @@ void Widget::setInitialState()
  *  it gives a hint based on the information available to the player.
  *  A hint indicates a cell with no mine and suggested cell is displayed as a green cell
  *  Asking for a hint twice for a cell, reveals the cell
+ *  When no cell is certainly safe near the end of the game, the guess most likely to win the game is searched
+ *  in the background, showGuess() marks it. A search still running was started from an older position,
+ *  it is cancelled by every click
  */
 void Widget::giveHint() {
 
+    clearGuess();
+    cancelGuess();
+
+    // The board repeats the marking process until a pass with no change to cell marks is made,
+    // then returns a safe marked unrevealed cell
+    int index = m_board->findHint();
+
+    if (index < 0) {
+        const std::uint8_t* visibleState = m_board->visibleState();
+        m_guessState.assign(visibleState, visibleState + m_topology.cellAmount());
+        m_guessMineAmount = m_board->mineAmount();
+        m_guessGameNumber = m_gameNumber;
+        m_hintButton->setText("Searching...");
+        m_guessWatcher->setFuture(QtConcurrent::run([this]() {
+            return m_endgameSolver.solve(m_topology, m_guessState.data(), m_guessMineAmount);
+        }));
+        return;
+    }
 
-    // Repeats the marking process until a pass with no change to cell marks is made.
-    bool changeOccured = true;      // Determines whether a change is made or not
-    while(changeOccured) {
+    m_hintButton->setText("Hint");
 
-        changeOccured = false;
+    // On a large board the hinted cell may be out of view
+    if (m_boardView) {
+        if (m_board->isHinted(index)) {
+            m_boardView->revealCell(index);
+        }
+        m_board->setHinted(index);
+        m_boardView->updateCell(index);
+        m_boardView->centerOn(index);
+        return;
+    }
 
-        // Iterate over each cell, mark cells that are certain to contain a mine as unsafe
-        for(int i = 0; i < ROW_NUMBER; i++) {
-            for(int j = 0; j < COLUMN_NUMBER; j++) {
+    Cell* hintedCell = m_cells[index];
 
-                Cell* currentCell = m_cellArray[i][j];
+    // If the cell is already hinted, reveal the cell
+    if (m_board->isHinted(index)) {
+        hintedCell->revealCell();
+    }
 
-                // When a cell has unrevealed, unmarked neighbours as much as its neighbouring mines,
-                // mark all unmarked neighbours as unsafe, since they certainly contain a mine
-                if (currentCell->m_isRevealed && currentCell->m_numberOfNeighbouringMines != 0) {
-                    if(currentCell->m_numberOfNeighbouringMines == (currentCell->getUnrevealedNeighbourAmount() - currentCell->getSafeNeighbourAmount()))
-                    {
-                        // If any cell is marked, a change is made so loop continues
-                        bool change = currentCell->markNeighboursAsUnsafe();
-                        if(change) {
-                            changeOccured = true;
-                        }
+    // Make cell hinted, a flagged cell, when hinted, is unflagged by the board
+    m_board->setHinted(index);
+    hintedCell->m_cellButton->setIcon(QIcon(":/image/hint.png"));
+}
 
-                    }
-                }
-            }
-        }
+/*
+ * Called when the endgame search is done
+ * The hint button shows the chance to win with the guess, or only the chance that it is safe if the search
+ * ran out of time before finishing any cell
+ */
+void Widget::showGuess()
+{
+    EndgameResult guess = m_guessWatcher->result();
 
-        // Iterate over each cell, mark cells that are certain to not contain a mine as safe
-        for(int i = 0; i < ROW_NUMBER; i++) {
-            for(int j = 0; j < COLUMN_NUMBER; j++) {
-
-                Cell* currentCell = m_cellArray[i][j];
-
-                // When a cell has unmarked, unrevealed neighbours and all the cells containing mines are marked
-                // mark all unmarked cells as safe since they certainly don't contain a mine
-                if (currentCell->m_isRevealed && currentCell->m_numberOfNeighbouringMines != 0) {
-                    if(currentCell->m_numberOfNeighbouringMines == currentCell->getUnsafeNeighbourAmount()) {
-
-                        // If any cell is marked, a change is made so loop continues
-                        bool change = currentCell->markUnmarkedNeighboursAsSafe();
-                        if(change) {
-                            changeOccured = true;
-                        }
-                    }
-                }
-            }
-        }
+    // The player may have played, flagged or restarted during the search
+    if (m_guessGameNumber != m_gameNumber || guess.status == EndgameStatus::Cancelled)
+        return;
+    m_hintButton->setText("Hint");
+    if (guess.cell < 0 || m_board->mineAmount() != m_guessMineAmount
+        || std::memcmp(m_board->visibleState(), m_guessState.data(), m_guessState.size()) != 0)
+        return;
+
+    QString chance = guess.isWinProbabilityKnown ? QString("%1% to win").arg(qRound(guess.winProbability * 100))
+                                                 : QString("%1% safe").arg(qRound(guess.safeProbability * 100));
+    if (guess.status == EndgameStatus::TimedOut)
+        chance += ", timed out";
+    m_hintButton->setText("Guess: " + chance);
+
+    m_guessCell = guess.cell;
+    if (m_boardView) {
+        m_boardView->setGuessCell(m_guessCell);
+        m_boardView->centerOn(m_guessCell);
+        return;
     }
+    m_cells[m_guessCell]->m_cellButton->setIcon(QIcon(":/image/guess.png"));
+}
 
-    // After the marking process is complete, iterate over each cell,
-    // and give a safe marked unrevealed cell as hinted cell
-    for(int i = 0; i < ROW_NUMBER; i++) {
-        for(int j = 0; j < COLUMN_NUMBER; j++) {
+/*
+ * The search looks at the cancel flag as often as at the clock, so this doesn't wait for the rest of its time budget
+ * The finished signal of the cancelled search may still call showGuess(), which drops the cancelled result
+ */
+void Widget::cancelGuess()
+{
+    if (!m_guessWatcher->isRunning())
+        return;
 
-            Cell* currentCell = m_cellArray[i][j];
+    m_isGuessCancelled = true;
+    m_guessWatcher->waitForFinished();
+    m_isGuessCancelled = false;
+}
 
-            // determine whether the cell is eligible to be a hint suggestion or not
-            if(currentCell->m_isMarkedSafe && !currentCell->m_isRevealed) {
+// A guess the player flagged or revealed keeps what the player did
+void Widget::clearGuess()
+{
+    if (m_guessCell < 0)
+        return;
+
+    if (m_boardView)
+        m_boardView->setGuessCell(-1);
+    else if (m_board->visibleState()[m_guessCell] == Board::Hidden)
+        m_cells[m_guessCell]->m_cellButton->setIcon(QIcon(":/image/empty.png"));
+    m_guessCell = -1;
+}
 
-                // If the cell is already hinted, reveal the cell
-                if(currentCell->m_isHinted) {
-                    currentCell->revealCell();
-                }
+/*
+ * Triggered by Ctrl+S
+ * Saves the whole board as one PNG at full sprite resolution, whatever the size of the board on screen
+ */
+void Widget::saveSnapshot()
+{
+    QString path = QFileDialog::getSaveFileName(this, "Save snapshot", "board.png", "PNG image (*.png)");
+    if (path.isEmpty())
+        return;
 
-                // Adjust member variables to make cell hinted.
-                currentCell->m_isHinted = true;
-                currentCell->m_cellButton->setIcon(QIcon(":/image/hint.png"));
-                currentCell->m_isFlagged = false;       // A flagged cell, when hinted, should be unflagged
-                return;
-            }
-        }
-    }
+    BoardRenderer renderer(*m_board);
+    if (!renderer.writePng(path))
+        QMessageBox::warning(this, "Snapshot", "Couldn't save " + path);
+}
 
+/*
+ * Triggered by Ctrl+Shift+S
+ * Saves the board as a folder of tiles, for boards whose single image would be too large to open
+ */
+void Widget::saveTileSnapshot()
+{
+    QString directory = QFileDialog::getExistingDirectory(this, "Save snapshot tiles");
+    if (directory.isEmpty())
+        return;
+
+    BoardRenderer renderer(*m_board);
+    if (!renderer.writeTiles(directory))
+        QMessageBox::warning(this, "Snapshot", "Couldn't save the tiles to " + directory);
 }
 
 /*
@@ -402,7 +504,6 @@ void Widget::giveHint() {
 void Widget::restart() {
     destroyPreviousElements();
     setInitialState();
-    Cell::s_revealedCellAmount = 0;
 }
 
 /*
@@ -413,7 +514,7 @@ void Widget::setWinScreen()
 {
     QObject::disconnect(m_hintButton, &QPushButton::clicked, this, &Widget::giveHint);
     revealAllCells();
-    m_scoreLabel->setText("Score: " + QString::number(COLUMN_NUMBER * ROW_NUMBER));
+    m_scoreLabel->setText("Score: " + QString::number(m_topology.activeCellAmount()));
     QMessageBox::information(this, "Winner!", "You Won!");
 
 }
@@ -437,18 +538,36 @@ void Widget::setLoseScreen()
  */
 void Widget::destroyPreviousElements() {
 
+    // Drop the cells of the previous game that are not shown yet
+    m_revealTimer->stop();
+    m_pendingReveals.clear();
+    m_pendingRevealPosition = 0;
+
+    // A search still running belongs to the previous game
+    cancelGuess();
+    m_gameNumber++;
+    m_guessCell = -1;
+
     // delete score and buttons
     delete(m_scoreLabel);
     delete(m_restartButton);
     delete(m_hintButton);
 
     // delete cell buttons and labels by iterating over each cell
-    for (int i = 0; i < ROW_NUMBER; i++) {
-        for(int j = 0; j < COLUMN_NUMBER; j++) {
-            delete(m_cellArray[i][j]->m_cellButton);
-            delete(m_cellArray[i][j]->m_cellLabel);
-        }
+    for (Cell* cell : m_cells) {
+        if (!cell)
+            continue;
+        delete(cell->m_cellButton);
+        delete(cell->m_cellLabel);
+        delete(cell);
     }
+    m_cells.clear();
+    delete(m_boardView);
+    m_boardView = nullptr;
     delete(m_cellGrid);
 
+    // delete the state of the previous game
+    delete(m_board);
+    m_board = nullptr;
+
 }
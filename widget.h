@@ -8,7 +8,22 @@
 #include <cellbutton.h>
 #include <QMessageBox>
 #include <QPushButton>
+#include <QFutureWatcher>
 #include <QLabel>
+#include <QTimer>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "board.h"
+#include "boardview.h"
+#include "endgamesolver.h"
+#include "topology.h"
+
+#define REVEAL_SLICE_MS 2                // Longest time spent on showing revealed cells in one event loop turn
+#define REVEAL_WAVE_FRAME_MS 16          // Time between two steps of the wave-front animation
+#define REVEAL_WAVE_CELLS_PER_FRAME 64   // Number of cells shown in each step of the wave-front animation
+#define REVEAL_WAVE_MAX_FRAMES 60        // Larger cascades show more cells per step, so that no wave takes much longer than a second
+#define BOARD_VIEW_CELLS 900             // Boards with more cells are drawn by a zoomable BoardView instead of a button per cell
 
 /*
  * This class is responsible for setting the UI elements such as buttons, labels, layouts
@@ -23,7 +38,12 @@ class Widget : public QWidget
 private:
 
 
-    Cell* m_cellArray[ROW_NUMBER][COLUMN_NUMBER];   // Allows easy access for each cell by storing them using row and column index.
+    Topology m_topology;                            // Shape of the board, kept across restarts
+    Board* m_board = nullptr;                       // Game state and rules of the current game
+    std::vector<Cell*> m_cells;                     // UI of each cell, indexed like the board. Holes of the topology have no cell (nullptr)
+    BoardView* m_boardView = nullptr;               // UI of the whole board on large boards, m_cells is empty then
+    int m_mineAmount = MINE_AMOUNT;                 // Mines of each game
+    EndgameSolver m_endgameSolver;                  // Finds the guess most likely to win when the hint algorithm has no safe cell
 
     // ************** UI elements ***************
     QGridLayout* mainLayout;                        // Constructs the skeleton of the widget. Contains every other UI element                                                    // Contains all cells which holds buttons and labels for
@@ -32,13 +52,39 @@ private:
     QPushButton* m_restartButton;                   // When clicked, restarts the game with a different distribution of the mines.
     QLabel* m_scoreLabel;                           // Displays the current score of the player.
 
+    // ************** Progressive reveal ***************
+    // The board computes every revealed cell at once, the UI of these cells is updated a slice at a time
+    // so that the event loop keeps running while a large cascade is displayed
+    QTimer* m_revealTimer;                          // Calls applyPendingReveals() on each event loop turn while cells are pending
+    std::vector<int> m_pendingReveals;              // Cells revealed by the board whose UI is not updated yet
+    std::size_t m_pendingRevealPosition = 0;        // First entry of m_pendingReveals that is not shown yet
+    bool m_isProgressiveReveal = true;              // When false, every reveal is shown at once inside the mouse event
+    bool m_isWaveAnimation = false;                 // When true, revealed cells are shown in steps, spreading out from the clicked cell
+
+    // ************** Endgame guess ***************
+    // When no cell is certainly safe the best guess is searched on a worker thread, the board stays playable meanwhile
+    // A guess may be a mine: it has its own icon, it is not hinted on the board and the hint button never reveals it
+    QFutureWatcher<EndgameResult>* m_guessWatcher;  // Runs m_endgameSolver on m_guessState, calls showGuess() when done
+    std::vector<std::uint8_t> m_guessState;         // Visible state the search started from, unchanged while it runs
+    int m_guessMineAmount = 0;
+    int m_gameNumber = 0;                           // Counts restarts, a guess searched in a previous game is dropped
+    int m_guessGameNumber = 0;
+    int m_guessCell = -1;                           // Cell shown as the suggested guess, -1 if none
+    std::atomic<bool> m_isGuessCancelled{false};    // Cancel flag of m_endgameSolver, set only by cancelGuess()
+
     void destroyPreviousElements();                 // Destroys the previous UI elements after restart button is clicked
+    void clearGuess();                              // Removes the mark of the suggested guess
+    void cancelGuess();                             // Stops the running endgame search, if any, and waits for it
 public:
 
     Widget(QWidget *parent = nullptr);
     ~Widget();
 
 
+    void setTopology(const Topology& topology);     // Changes the shape of the board (rectangle, torus, masked) and restarts the game
+    void setMineAmount(int mineAmount);             // Changes the number of mines and restarts the game
+    void setEndgameCells(int cellAmount);           // Largest unknown region searched for the best guess by the hint button
+    void setProgressiveReveal(bool isProgressive, bool isWaveAnimation = false);   // Chooses how the revealed cells are displayed
     int setCellSize(int columnNum, int rowNum);     // Sets the size of each cell based on total number of cells
     void initializeCells();                         // Instantiates a predetermined amount of cells with their corresponding buttons
     void generateMines(int mineAmount);             // Distributes mines randomly on the cells and the quantity is given by mineAmount
@@ -52,8 +98,13 @@ public slots:
     // Slots related to a button press
     void restart();                                 // Defines the actions to be taken when m_restartButton is clicked
     void giveHint();                                // Defines the actions to be taken when m_hintButton is clicked
+    void saveSnapshot();                            // Saves the board as a PNG image, triggered by Ctrl+S
+    void saveTileSnapshot();                        // Saves the board as PNG tiles in a folder, triggered by Ctrl+Shift+S
 
     // Slots related to the game logic
+    void showRevealedCells(const std::vector<int>& revealedCells);  // Updates the UI of the cells opened by a reveal and the score
+    void applyPendingReveals();                     // Shows the next slice of pending revealed cells
+    void showGuess();                               // Marks the guess found by the endgame search, if the board didn't change meanwhile
     void setLoseScreen();                           // Called when lose condition(Player reveals all a mine cells) is triggered
     void setWinScreen();                            // Called when win condition(Player reveals all non-mine cells) is triggered
 